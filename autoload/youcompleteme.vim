@@ -51,10 +51,20 @@ let s:pollers = {
       \     'id': -1,
       \     'wait_milliseconds': 100,
       \   },
+      \   'delayed_file_parse': {
+      \     'id': -1,
+      \   },
+      \   'buffer_prefetch': {
+      \     'id': -1,
+      \     'wait_milliseconds': 100,
+      \   },
       \   'server_ready': {
       \     'id': -1,
       \     'wait_milliseconds': 100,
       \   },
+      \   'server_recovery': {
+      \     'id': -1,
+      \   },
       \   'receive_messages': {
       \     'id': -1,
       \     'wait_milliseconds': 100,
@@ -83,7 +93,9 @@ let s:buftype_blacklist = {
 let s:last_char_inserted_by_user = v:true
 let s:enable_hover = 0
 let s:cursorhold_popup = -1
-let s:enable_inlay_hints = 0
+" -1 until inlay hints are first needed; then whether Vim supports them.
+let s:enable_inlay_hints = -1
+let s:semantic_highlighting_initialised = 0
 
 let s:force_preview_popup = 0
 
@@ -134,6 +146,7 @@ endfunction
 
 
 function! youcompleteme#Enable()
+  let enable_start_time = reltime()
   call s:SetUpBackwardsCompatibility()
 
   let completeopt = split( &completeopt, ',' )
@@ -183,9 +196,6 @@ function! youcompleteme#Enable()
 
   call s:SetUpOptions()
 
-  py3 ycm_semantic_highlighting.Initialise()
-  let s:enable_inlay_hints = py3eval( 'ycm_inlay_hints.Initialise()' ) ? 1 : 0
-
   call youcompleteme#EnableCursorMovedAutocommands()
   augroup youcompleteme
     autocmd!
@@ -199,8 +209,11 @@ function! youcompleteme#Enable()
     " buffer is already parsed.
     autocmd BufWritePost,FileWritePost * call s:OnFileSave()
     autocmd FileType * call s:OnFileTypeSet()
+    autocmd Syntax * call s:OnSyntaxSet()
     autocmd BufEnter,CmdwinEnter,WinEnter * call s:OnBufferEnter()
     autocmd BufUnload * call s:OnBufferUnload()
+    autocmd BufWipeout * call s:OnBufferWipeout()
+    autocmd CursorHold * call s:StartBufferPrefetch()
     autocmd InsertLeave * call s:OnInsertLeave()
     autocmd VimLeave * call s:OnVimLeave()
     autocmd CompleteDone * call s:OnCompleteDone()
@@ -229,6 +242,9 @@ function! youcompleteme#Enable()
         \ :call youcompleteme#finder#FindSymbol( 'workspace' )<CR>
   nnoremap <silent> <plug>(YCMFindSymbolInDocument)
         \ :call youcompleteme#finder#FindSymbol( 'document' )<CR>
+
+  call py3eval( 'ycm_startup_profile.RecordSeconds( "youcompleteme#Enable", ' .
+              \ reltimestr( reltime( enable_start_time ) ) . ' )' )
 endfunction
 
 
@@ -280,10 +296,18 @@ sys.path[ 0:0 ] = [ p.join( root_folder, 'python' ),
 
 # We enclose this code in a try/except block to avoid backtraces in Vim.
 try:
-  # Import the modules used in this file.
-  from ycm import base, vimsupport, youcompleteme
-  from ycm import semantic_highlighting as ycm_semantic_highlighting
-  from ycm import inlay_hints as ycm_inlay_hints
+  from ycm import startup_profile as ycm_startup_profile
+
+  # Import the modules used in this file. The semantic highlighting and inlay
+  # hints modules are imported when these features are first used.
+  with ycm_startup_profile.Measure( 'Python imports' ):
+    from ycm import base, vimsupport, youcompleteme
+
+  # Count the calls to Vim made by each module for :YcmStats. This slows down
+  # every call so it must be enabled explicitly.
+  if vimsupport.GetBoolValue( 'g:ycm_count_vim_calls' ):
+    from ycm import metrics
+    metrics.InstrumentVimBridge( vim )
 
   if 'ycm_state' in globals():
     # If re-initializing, pretend that we shut down
@@ -551,11 +575,18 @@ function! s:DisableOnLargeFile( buffer )
   endif
 
   let threshold = g:ycm_disable_for_files_larger_than_kb * 1024
-  let b:ycm_largefile =
-        \ threshold > 0 && getfsize( expand( a:buffer ) ) > threshold
+  let large = threshold > 0 && getfsize( expand( a:buffer ) ) > threshold
+  " In large file mode, YCM stays enabled but does less work; see
+  " vimsupport.LARGE_FILE_BUFFERS. b:ycm_largefile is set when YCM is disabled.
+  let b:ycm_largefile = large && !g:ycm_large_file_mode
   if b:ycm_largefile
     py3 vimsupport.PostVimMessage( 'YouCompleteMe is disabled in this buffer;' +
           \ ' the file exceeded the max size (see YCM options).' )
+  elseif large
+    py3 vimsupport.EnableLargeFileMode(
+          \ vimsupport.GetIntValue( 'bufnr( a:buffer )' ) )
+    py3 vimsupport.PostVimMessage( 'YouCompleteMe is in large file mode in ' +
+          \ 'this buffer; the file exceeded the max size (see YCM options).' )
   endif
   return b:ycm_largefile
 endfunction
@@ -735,6 +766,21 @@ function! s:DisableAutoHover()
 endfunction
 
 
+function! s:OnSyntaxSet()
+  " Checked here so that the option can be enabled with :YcmReloadOptions.
+  if !g:ycm_seed_identifiers_with_syntax
+    return
+  endif
+  let buffer_number = str2nr( expand( '<abuf>' ) )
+  if !s:AllowedToCompleteInBuffer( buffer_number )
+    return
+  endif
+
+  let syntax = expand( '<amatch>' )
+  py3 ycm_state.OnSyntaxSet( vim.eval( "syntax" ) )
+endfunction
+
+
 function! s:OnFileTypeSet()
   " The contents of the command-line window are empty when the filetype is set
   " for the first time. Users should never change its filetype so we only rely
@@ -781,6 +827,7 @@ endfunction
 
 
 function! s:OnBufferEnter()
+  call s:StopBufferPrefetch()
   call s:StartMessagePoll()
   if !s:VisitedBufferRequiresReparse()
     return
@@ -793,6 +840,12 @@ function! s:OnBufferEnter()
 
   py3 ycm_state.UpdateMatches()
   py3 ycm_state.OnBufferVisit()
+  " The buffer was parsed while hidden and didn't change since (see
+  " g:ycm_prefetch_buffers) so only its diagnostics need to be displayed.
+  if py3eval( 'ycm_state.UsePrefetchedParse()' )
+    call s:HandlePrefetchedFileParse()
+    return
+  endif
   " Last parse may be outdated because of changes from other buffers. Force a
   " new parse.
   call s:OnFileReadyToParse( 1 )
@@ -811,9 +864,18 @@ function! s:OnBufferUnload()
 endfunction
 
 
+function! s:OnBufferWipeout()
+  " The buffer number can't be reused so forget everything we know about it,
+  " whatever its filetype.
+  let buffer_number = str2nr( expand( '<abuf>' ) )
+  py3 ycm_state.OnBufferWipeout( vimsupport.GetIntValue( 'buffer_number' ) )
+endfunction
+
+
 function! s:PollServerReady( timer_id )
   if !py3eval( 'ycm_state.IsServerAlive()' )
     py3 ycm_state.NotifyUserIfServerCrashed()
+    call s:ScheduleServerRecovery()
     " Server crashed. Don't poll it again.
     return
   endif
@@ -826,6 +888,29 @@ function! s:PollServerReady( timer_id )
   endif
 
   call s:OnFileTypeSet()
+  " Send the other buffers that were open if the server was restarted.
+  py3 ycm_state.ReplayBuffers()
+endfunction
+
+
+function! s:ScheduleServerRecovery()
+  if s:pollers.server_recovery.id >= 0
+    return
+  endif
+
+  let delay = py3eval( 'ycm_state.ServerRecoveryDelay()' )
+  if delay >= 0
+    let s:pollers.server_recovery.id = timer_start(
+          \ delay,
+          \ function( 's:RecoverServer' ) )
+  endif
+endfunction
+
+
+function! s:RecoverServer( timer_id )
+  let s:pollers.server_recovery.id = -1
+  py3 ycm_state.RecoverServer()
+  call s:WaitForRestartedServer()
 endfunction
 
 
@@ -835,31 +920,84 @@ function! s:OnFileReadyToParse( ... )
   " effectively forcing a parse of the buffer. Default is 0.
   let force_parsing = a:0 > 0 && a:1
 
+  if force_parsing
+    call s:SendFileReadyToParse()
+    return
+  endif
+
   " We only want to send a new FileReadyToParse event notification if the buffer
   " has changed since the last time we sent one, or if forced.
-  if force_parsing || py3eval( "ycm_state.NeedsReparse()" )
-    " We switched buffers or something, so clear.
-    " FIXME: sig help should be buffer local?
-    call s:ClearSignatureHelp()
-    py3 ycm_state.OnFileReadyToParse()
+  if !py3eval( "ycm_state.NeedsReparse()" )
+    return
+  endif
 
-    call s:StopPoller( s:pollers.file_parse_response )
-    let s:pollers.file_parse_response.id = timer_start(
-          \ s:pollers.file_parse_response.wait_milliseconds,
-          \ function( 's:PollFileParseResponse' ) )
+  " Buffers that take long to parse are parsed once the user stops editing for
+  " a while.
+  let delay = py3eval( "ycm_state.ParseDelay()" )
+  if delay <= 0
+    call s:SendFileReadyToParse()
+    return
+  endif
+
+  call s:StopPoller( s:pollers.delayed_file_parse )
+  let s:pollers.delayed_file_parse.id = timer_start(
+        \ delay,
+        \ function( 's:OnDelayedFileReadyToParse', [ bufnr() ] ) )
+endfunction
 
-    call s:UpdateSemanticHighlighting( bufnr(), 1, 0 )
-    call s:UpdateInlayHints( bufnr(), 1, 0 )
 
+function! s:OnDelayedFileReadyToParse( bufnr, ... )
+  let s:pollers.delayed_file_parse.id = -1
+  " The buffer is parsed anyway when entering it again.
+  if bufnr() == a:bufnr && py3eval( "ycm_state.NeedsReparse()" )
+    call s:SendFileReadyToParse()
   endif
 endfunction
 
+
+function! s:SendFileReadyToParse()
+  call s:StopPoller( s:pollers.delayed_file_parse )
+
+  " We switched buffers or something, so clear.
+  " FIXME: sig help should be buffer local?
+  call s:ClearSignatureHelp()
+  py3 ycm_state.OnFileReadyToParse()
+  call s:ScheduleServerRecovery()
+
+  call s:StopPoller( s:pollers.file_parse_response )
+  let s:pollers.file_parse_response.id = timer_start(
+        \ s:pollers.file_parse_response.wait_milliseconds,
+        \ function( 's:PollFileParseResponse' ) )
+
+  call s:UpdateSemanticHighlighting( bufnr(), 1, 0 )
+  call s:UpdateInlayHints( bufnr(), 1, 0 )
+endfunction
+
+
+function! s:HandlePrefetchedFileParse()
+  call s:StopPoller( s:pollers.delayed_file_parse )
+  call s:ClearSignatureHelp()
+
+  call s:StopPoller( s:pollers.file_parse_response )
+  call s:PollFileParseResponse()
+
+  call s:UpdateSemanticHighlighting( bufnr(), 1, 0 )
+  call s:UpdateInlayHints( bufnr(), 1, 0 )
+endfunction
+
+
 function! s:UpdateSemanticHighlighting( bufnr, force, redraw_anyway ) abort
   call s:StopPoller( s:pollers.semantic_highlighting )
   if !s:is_neovim &&
         \ get( b:, 'ycm_enable_semantic_highlighting',
         \   get( g:, 'ycm_enable_semantic_highlighting', 0 ) )
 
+    if !s:semantic_highlighting_initialised
+      py3 from ycm import semantic_highlighting as ycm_semantic_highlighting
+      py3 ycm_semantic_highlighting.Initialise()
+      let s:semantic_highlighting_initialised = 1
+    endif
+
     if py3eval(
         \ 'ycm_state.Buffer( int( vim.eval( "a:bufnr" ) ) ).'
         \ . 'semantic_highlighting.Request( '
@@ -875,10 +1013,19 @@ function! s:UpdateSemanticHighlighting( bufnr, force, redraw_anyway ) abort
 endfunction
 
 
+function s:InlayHintsSupported()
+  if s:enable_inlay_hints < 0
+    py3 from ycm import inlay_hints as ycm_inlay_hints
+    let s:enable_inlay_hints = py3eval( 'ycm_inlay_hints.Initialise()' ) ? 1 : 0
+  endif
+  return s:enable_inlay_hints
+endfunction
+
+
 function s:ShouldUseInlayHintsNow( bufnr )
-  return s:enable_inlay_hints &&
-        \ getbufvar( a:bufnr, 'ycm_enable_inlay_hints',
-        \   get( g:, 'ycm_enable_inlay_hints', 0 ) )
+  return getbufvar( a:bufnr, 'ycm_enable_inlay_hints',
+        \   get( g:, 'ycm_enable_inlay_hints', 0 ) ) &&
+        \ s:InlayHintsSupported()
 endfunction
 
 function! s:UpdateInlayHints( bufnr, force, redraw_anyway ) abort
@@ -899,6 +1046,40 @@ function! s:UpdateInlayHints( bufnr, force, redraw_anyway ) abort
 endfunction
 
 
+function! s:StartBufferPrefetch()
+  " The option is checked here rather than when defining the autocommand so
+  " that it can be enabled with :YcmReloadOptions.
+  if g:ycm_prefetch_buffers <= 0 || !s:AllowedToCompleteInCurrentBuffer()
+    return
+  endif
+
+  call s:StopPoller( s:pollers.buffer_prefetch )
+  py3 ycm_state.StartBufferPrefetch()
+  call s:PollBufferPrefetch()
+endfunction
+
+
+function! s:PollBufferPrefetch( ... )
+  if py3eval( 'ycm_state.PollBufferPrefetch()' )
+    let s:pollers.buffer_prefetch.id = timer_start(
+          \ s:pollers.buffer_prefetch.wait_milliseconds,
+          \ function( 's:PollBufferPrefetch' ) )
+  else
+    let s:pollers.buffer_prefetch.id = -1
+  endif
+endfunction
+
+
+function! s:StopBufferPrefetch()
+  " Prefetching is stopped as soon as the user does something.
+  if s:pollers.buffer_prefetch.id < 0
+    return
+  endif
+  call s:StopPoller( s:pollers.buffer_prefetch )
+  py3 ycm_state.StopBufferPrefetch()
+endfunction
+
+
 function! s:PollFileParseResponse( ... )
   if !py3eval( "ycm_state.FileParseRequestReady()" )
     let s:pollers.file_parse_response.id = timer_start(
@@ -1001,10 +1182,12 @@ function! s:OnWinScrolled()
   let bufnr = winbufnr( expand( '<afile>' ) )
   call s:UpdateSemanticHighlighting( bufnr, 0, 0 )
   call s:UpdateInlayHints( bufnr, 0, 0 )
+  py3 ycm_state.OnWinScrolled( vimsupport.GetIntValue( 'bufnr' ) )
 endfunction
 
 
 function! s:OnTextChangedNormalMode()
+  call s:StopBufferPrefetch()
   if !s:AllowedToCompleteInCurrentBuffer()
     return
   endif
@@ -1060,6 +1243,7 @@ endfunction
 
 
 function! s:OnInsertEnter() abort
+  call s:StopBufferPrefetch()
   let s:current_cursor_position = getpos( '.' )
   py3 ycm_state.OnInsertEnter()
   if s:ShouldUseInlayHintsNow( bufnr() ) &&
@@ -1394,7 +1578,10 @@ endfunction
 
 function! s:SetUpCommands()
   command! YcmRestartServer call s:RestartServer()
+  command! YcmReloadOptions call s:ReloadOptions()
   command! YcmDebugInfo call s:DebugInfo()
+  command! YcmStartupProfile call s:StartupProfile()
+  command! YcmStats call s:Stats()
   command! -nargs=* -complete=custom,youcompleteme#LogsComplete -count=0
         \ YcmToggleLogs call s:ToggleLogs( <f-count>,
                                          \ <f-mods>,
@@ -1415,8 +1602,19 @@ endfunction
 function! s:RestartServer()
   call s:SetUpOptions()
 
+  call s:StopPoller( s:pollers.server_recovery )
   py3 ycm_state.RestartServer()
+  call s:WaitForRestartedServer()
+endfunction
+
+
+function! s:ReloadOptions()
+  call s:SetUpOptions()
+  py3 ycm_state.ReloadOptions()
+endfunction
 
+
+function! s:WaitForRestartedServer()
   call s:StopPoller( s:pollers.receive_messages )
   call s:StopPoller( s:pollers.command )
   call s:ClearSignatureHelp()
@@ -1441,6 +1639,22 @@ function! s:DebugInfo()
 endfunction
 
 
+function! s:StartupProfile()
+  echom "Printing YouCompleteMe startup profile..."
+  for line in split( py3eval( 'ycm_startup_profile.FormatReport()' ), "\n" )
+    echom '-- ' . line
+  endfor
+endfunction
+
+
+function! s:Stats()
+  echom "Printing YouCompleteMe statistics..."
+  for line in split( py3eval( 'ycm_state.FormatStats()' ), "\n" )
+    echom '-- ' . line
+  endfor
+endfunction
+
+
 function! s:ToggleLogs( count, ... )
   py3 ycm_state.ToggleLogs( vimsupport.GetIntValue( 'a:count' ),
                           \ *vim.eval( 'a:000' ) )
@@ -1619,8 +1833,16 @@ endfunction
 
 
 if exists( '*popup_atcursor' )
-  function s:Hover()
-    if !py3eval( 'ycm_state.NativeFiletypeCompletionUsable()' )
+  " Only block until the server tells if the filetype has a semantic completer
+  " when |a:1| is set, i.e. when the user asked for the hover.
+  function s:Hover( ... )
+    let block = a:0 > 0 && a:1
+    if !py3eval( 'ycm_state.NativeFiletypeCompletionUsable( ' .
+               \ ( block ? 'True' : 'False' ) . ' )' )
+      " Try again on the next CursorHold until the server answers.
+      if !block && py3eval( 'ycm_state.CompleterAvailabilityPending()' )
+        return
+      endif
       " Cancel the autocommand if it happens to have been set
       call s:DisableAutoHover()
       return
@@ -1722,7 +1944,7 @@ if exists( '*popup_atcursor' )
         autocmd CursorMoved <buffer> call s:EnableAutoHover()
       augroup END
     else
-      call s:Hover()
+      call s:Hover( 1 )
     endif
   endfunction
 
@@ -1753,7 +1975,7 @@ function! s:ToggleInlayHints()
         \       'ycm_enable_inlay_hints',
         \       get( g:, 'ycm_enable_inlay_hints' ) )
 
-  if !b:ycm_enable_inlay_hints && s:enable_inlay_hints
+  if !b:ycm_enable_inlay_hints && s:InlayHintsSupported()
     py3 ycm_state.CurrentBuffer().inlay_hints.Clear()
   else
     call s:UpdateInlayHints( bufnr(), 0, 1 )
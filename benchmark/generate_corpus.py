@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Generates a synthetic C++ project along with the responses ycmd would send
+for it, to benchmark the client on projects much larger than the files in
+test/testdata/cpp.
+
+The project is made of a header and a source file per module, the headers
+including each other in chains, and of a main.cc file using all the modules.
+Some lines of main.cc use undeclared identifiers and are reported in the
+diagnostics.
+
+The responses are written in the responses directory, one JSON file per
+request: completions, diagnostics (response to the FileReadyToParse event),
+FixIt, GoToReferences and semantic tokens, all for main.cc. exchanges.jsonl
+holds the same responses in the format of session_replay.py so that they can
+be served by its stub server.
+
+By default, the sizes are those of the C++ files in test/testdata/cpp. The
+--scale option multiplies the number of modules, the length of main.cc and the
+number of results in each response."""
+
+import argparse
+import json
+import os
+import os.path as p
+import random
+import re
+
+# Sizes of the test/testdata/cpp files, multiplied by --scale.
+BASE_MODULES = 8
+BASE_MAIN_LINES = 32
+BASE_COMPLETIONS = 16
+BASE_REFERENCES = 8
+# Not scaled.
+DEFAULT_SYMBOLS_PER_MODULE = 8
+DEFAULT_INCLUDE_DEPTH = 4
+DEFAULT_DIAGNOSTICS_PER_100_LINES = 3
+SCALES = [ 1, 10, 100, 1000 ]
+
+TOKEN_TYPES = [ 'namespace', 'type', 'variable', 'function', 'parameter' ]
+IDENTIFIER_REGEX = re.compile( r'[A-Za-z_]\w*' )
+KEYWORDS = { 'int', 'return' }
+
+
+def ModuleName( module ):
+  return f'module_{ module }'
+
+
+def StructName( module ):
+  return f'Module{ module }'
+
+
+def HeaderText( module, args ):
+  lines = [ '#pragma once' ]
+  # Each header includes the next one in its chain.
+  if ( module + 1 ) % args.include_depth and module + 1 < args.modules:
+    lines.append( f'#include "{ ModuleName( module + 1 ) }.h"' )
+  lines += [ '', 'namespace corpus {', '',
+             f'struct { StructName( module ) } {{' ]
+  for symbol in range( args.symbols_per_module ):
+    lines += [ f'  int field_{ symbol };',
+               f'  int Method_{ symbol }( int value ) const;' ]
+  lines += [ '};', '', '} // namespace corpus', '' ]
+  return '\n'.join( lines )
+
+
+def SourceText( module, args ):
+  lines = [ f'#include "{ ModuleName( module ) }.h"', '',
+            'namespace corpus {', '' ]
+  for symbol in range( args.symbols_per_module ):
+    lines += [ f'int { StructName( module ) }::Method_{ symbol }( '
+               'int value ) const {',
+               f'  return field_{ symbol } + value;',
+               '}', '' ]
+  lines += [ '} // namespace corpus', '' ]
+  return '\n'.join( lines )
+
+
+def MainText( args, error_statements, rng ):
+  """Returns the text of main.cc and the line of its first statement."""
+  lines = [ f'#include "{ ModuleName( module ) }.h"'
+            for module in range( 0, args.modules, args.include_depth ) ]
+  lines += [ '', 'int main() {' ]
+  first_statement = len( lines ) + 1
+  for statement in range( args.main_lines ):
+    if statement in error_statements:
+      lines.append( f'  int value_{ statement } = missing_{ statement };' )
+      continue
+    module = rng.randrange( args.modules )
+    symbol = rng.randrange( args.symbols_per_module )
+    lines.append( f'  int value_{ statement } = '
+                  f'corpus::{ StructName( module ) }().'
+                  f'Method_{ symbol }( { statement } );' )
+  lines += [ '  return 0;', '}', '' ]
+  return '\n'.join( lines ), first_statement
+
+
+def Location( filepath, line_num, column_num ):
+  return { 'filepath': filepath,
+           'line_num': line_num,
+           'column_num': column_num }
+
+
+def Range( filepath, line_num, start_column, end_column ):
+  return { 'start': Location( filepath, line_num, start_column ),
+           'end': Location( filepath, line_num, end_column ) }
+
+
+def CompletionsResponse( args, rng ):
+  completions = []
+  for completion in range( args.completions ):
+    module = rng.randrange( args.modules )
+    symbol = rng.randrange( args.symbols_per_module )
+    name = f'Method_{ symbol }'
+    completions.append( {
+      'insertion_text': name,
+      'menu_text': f'{ name }( int value ) const',
+      'extra_menu_info': 'int',
+      'kind': 'FUNCTION',
+      'detailed_info': f'int { StructName( module ) }::{ name }( int value ) '
+                       'const\n',
+      'extra_data': {}
+    } )
+  return { 'completions': completions,
+           'completion_start_column': 1,
+           'errors': [] }
+
+
+def Diagnostic( main_file, line_num, statement ):
+  start_column = len( f'  int value_{ statement } = ' ) + 1
+  end_column = start_column + len( f'missing_{ statement }' )
+  return {
+    'kind': 'ERROR',
+    'text': f"Use of undeclared identifier 'missing_{ statement }'",
+    'location': Location( main_file, line_num, start_column ),
+    'location_extent': Range( main_file, line_num, start_column, end_column ),
+    'ranges': [ Range( main_file, line_num, start_column, end_column ) ],
+    'fixit_available': True
+  }
+
+
+def FixItResponse( diagnostics ):
+  chunks = []
+  for diagnostic in diagnostics:
+    chunks.append( { 'replacement_text': '0',
+                     'range': diagnostic[ 'location_extent' ] } )
+  return { 'fixits': [ { 'text': 'Replace the undeclared identifiers',
+                         'location': diagnostics[ 0 ][ 'location' ],
+                         'chunks': chunks,
+                         'kind': 'quickfix',
+                         'resolve': False } ] if chunks else [] }
+
+
+def ReferencesResponse( root, args, rng ):
+  references = []
+  for reference in range( args.references ):
+    module = rng.randrange( args.modules )
+    symbol = rng.randrange( args.symbols_per_module )
+    # The line of the definition of the method in the source of the module.
+    line_num = 5 + 4 * symbol
+    references.append( {
+      'filepath': p.join( root, 'src', f'{ ModuleName( module ) }.cc' ),
+      'line_num': line_num,
+      'column_num': 1,
+      'description': f'int { StructName( module ) }::Method_{ symbol }( '
+                     'int value ) const {'
+    } )
+  return references
+
+
+def SemanticTokensResponse( main_file, main_lines ):
+  tokens = []
+  for line_num, line in enumerate( main_lines, 1 ):
+    if line.startswith( '#' ):
+      continue
+    for match in IDENTIFIER_REGEX.finditer( line ):
+      if match.group() in KEYWORDS:
+        continue
+      tokens.append( {
+        'range': Range( main_file,
+                        line_num,
+                        match.start() + 1,
+                        match.end() + 1 ),
+        'type': TOKEN_TYPES[ len( tokens ) % len( TOKEN_TYPES ) ],
+        'modifiers': []
+      } )
+  return { 'semantic_tokens': { 'tokens': tokens } }
+
+
+def WriteFile( filepath, text ):
+  os.makedirs( p.dirname( filepath ), exist_ok = True )
+  with open( filepath, 'w' ) as f:
+    f.write( text )
+
+
+def WriteJson( filepath, data ):
+  WriteFile( filepath, json.dumps( data ) )
+
+
+def Generate( args ):
+  root = p.abspath( args.output_dir )
+  rng = random.Random( args.seed )
+
+  for module in range( args.modules ):
+    WriteFile( p.join( root, 'include', f'{ ModuleName( module ) }.h' ),
+               HeaderText( module, args ) )
+    WriteFile( p.join( root, 'src', f'{ ModuleName( module ) }.cc' ),
+               SourceText( module, args ) )
+  WriteFile( p.join( root, 'compile_flags.txt' ), '-std=c++17\n-Iinclude\n' )
+
+  main_file = p.join( root, 'src', 'main.cc' )
+  # Rounded up so that the smallest projects have diagnostics too.
+  error_count = -( -args.main_lines * args.diagnostics_per_100_lines // 100 )
+  error_statements = sorted( rng.sample( range( args.main_lines ),
+                                         error_count ) )
+  main_text, first_statement = MainText( args, set( error_statements ), rng )
+  WriteFile( main_file, main_text )
+
+  diagnostics = [ Diagnostic( main_file, first_statement + statement,
+                              statement )
+                  for statement in error_statements ]
+  responses = {
+    'completions': ( 'completions', CompletionsResponse( args, rng ) ),
+    'diagnostics': ( 'event_notification', diagnostics ),
+    'fixit': ( 'run_completer_command', FixItResponse( diagnostics ) ),
+    'references': ( 'run_completer_command',
+                    ReferencesResponse( root, args, rng ) ),
+    'semantic_tokens': ( 'semantic_tokens',
+                         SemanticTokensResponse( main_file,
+                                                 main_text.splitlines() ) )
+  }
+
+  exchanges = []
+  for name, ( handler, response ) in responses.items():
+    WriteJson( p.join( root, 'responses', f'{ name }.json' ), response )
+    exchanges.append( json.dumps( { 'handler': handler,
+                                    'method': 'POST',
+                                    'request': None,
+                                    'status': 200,
+                                    'response': json.dumps( response ),
+                                    'seconds': 0 } ) )
+  WriteFile( p.join( root, 'responses', 'exchanges.jsonl' ),
+             '\n'.join( exchanges ) + '\n' )
+
+  print( f'Generated { args.modules } modules, a main.cc file of '
+         f'{ len( main_text.splitlines() ) } lines with { len( diagnostics ) } '
+         f'diagnostics and the responses in { root }' )
+
+
+def ParseArguments():
+  parser = argparse.ArgumentParser(
+    description = __doc__,
+    formatter_class = argparse.RawDescriptionHelpFormatter )
+  parser.add_argument( 'output_dir',
+                       help = 'Directory where the project is generated.' )
+  parser.add_argument( '--scale', type = int, choices = SCALES, default = 1,
+                       help = 'Size of the project relative to the test '
+                              'files.' )
+  parser.add_argument( '--modules', type = int,
+                       help = 'Number of modules. Overrides --scale.' )
+  parser.add_argument( '--main-lines', type = int,
+                       help = 'Number of statements in main.cc. Overrides '
+                              '--scale.' )
+  parser.add_argument( '--completions', type = int,
+                       help = 'Number of completions. Overrides --scale.' )
+  parser.add_argument( '--references', type = int,
+                       help = 'Number of references. Overrides --scale.' )
+  parser.add_argument( '--symbols-per-module', type = int,
+                       default = DEFAULT_SYMBOLS_PER_MODULE,
+                       help = 'Number of methods and fields of each module.' )
+  parser.add_argument( '--include-depth', type = int,
+                       default = DEFAULT_INCLUDE_DEPTH,
+                       help = 'Number of headers in each include chain.' )
+  parser.add_argument( '--diagnostics-per-100-lines', type = int,
+                       default = DEFAULT_DIAGNOSTICS_PER_100_LINES,
+                       help = 'Number of errors per 100 statements in '
+                              'main.cc.' )
+  parser.add_argument( '--seed', type = int, default = 0,
+                       help = 'Seed of the random generator.' )
+  args = parser.parse_args()
+
+  for option, base in [ ( 'modules', BASE_MODULES ),
+                        ( 'main_lines', BASE_MAIN_LINES ),
+                        ( 'completions', BASE_COMPLETIONS ),
+                        ( 'references', BASE_REFERENCES ) ]:
+    if getattr( args, option ) is None:
+      setattr( args, option, base * args.scale )
+  for option in [ 'modules', 'symbols_per_module', 'include_depth' ]:
+    if getattr( args, option ) < 1:
+      parser.error( f'--{ option.replace( "_", "-" ) } must be positive.' )
+  return args
+
+
+def Main():
+  Generate( ParseArguments() )
+
+
+if __name__ == '__main__':
+  Main()
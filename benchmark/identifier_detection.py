@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Measures the time taken by the identifier checks run on each keystroke in
+insert mode, base.CurrentIdentifierFinished and
+base.LastEnteredCharIsIdentifierChar, at the end of long lines. They are
+compared to checks scanning the whole line, as they did before. Both variants
+get the line and the cursor column from the same cached offsets of the line,
+which are computed before measuring, so that only the scan is compared."""
+
+import argparse
+import os.path as p
+import sys
+import timeit
+from unittest.mock import MagicMock, patch
+
+DIR_OF_THIS_SCRIPT = p.dirname( p.abspath( __file__ ) )
+sys.path[ 0 : 0 ] = [ p.join( DIR_OF_THIS_SCRIPT, '..', 'python' ),
+                      p.join( DIR_OF_THIS_SCRIPT, '..', 'third_party',
+                              'ycmd' ) ]
+
+# The Vim functions used by the checks are patched below.
+sys.modules[ 'vim' ] = MagicMock()
+
+from ycm import base, vimsupport
+from ycmd import identifier_utils
+from ycmd.utils import ToBytes
+
+LINE_LENGTH = 10000
+# Each line ends with an identifier followed by the character just typed.
+LINES = {
+  'minified JavaScript': 'function(a,b){return a.x+b.y};',
+  'CJK text': '変数の名前は識別子です。',
+  'emoji': 'status = "😀 done 🎉"; ',
+}
+
+
+def GenerateLine( pattern, length ):
+  repeat = length // len( pattern ) + 1
+  return ( pattern * repeat )[ : length - len( 'identifier.' ) ] + 'identifier.'
+
+
+def FullLineCurrentIdentifierFinished():
+  line, current_column = vimsupport.CurrentLineContentsAndCodepointColumn()
+  previous_char_index = current_column - 1
+  if previous_char_index < 0:
+    return True
+  filetype = vimsupport.CurrentFiletypes()[ 0 ]
+  regex = identifier_utils.IdentifierRegexForFiletype( filetype )
+  for match in regex.finditer( line ):
+    if match.end() == previous_char_index:
+      return True
+  return line[ : current_column ].isspace()
+
+
+def FullLineLastEnteredCharIsIdentifierChar():
+  line, current_column = vimsupport.CurrentLineContentsAndCodepointColumn()
+  if current_column - 1 < 0:
+    return False
+  filetype = vimsupport.CurrentFiletypes()[ 0 ]
+  return (
+    identifier_utils.StartOfLongestIdentifierEndingAtIndex(
+        line, current_column, filetype ) != current_column )
+
+
+CHECKS = [
+  ( 'CurrentIdentifierFinished',
+    FullLineCurrentIdentifierFinished,
+    base.CurrentIdentifierFinished ),
+  ( 'LastEnteredCharIsIdentifierChar',
+    FullLineLastEnteredCharIsIdentifierChar,
+    base.LastEnteredCharIsIdentifierChar ),
+]
+
+
+def Measure( function, repeat ):
+  return min( timeit.repeat( function, number = 1, repeat = repeat ) )
+
+
+def Main():
+  parser = argparse.ArgumentParser( description = __doc__ )
+  parser.add_argument( '--length', type = int, default = LINE_LENGTH,
+                       help = 'Length of the lines in characters.' )
+  parser.add_argument( '--repeat', type = int, default = 100,
+                       help = 'Number of measures of each check; the fastest '
+                              'one is reported.' )
+  args = parser.parse_args()
+
+  print( f'{ "Line":<22}{ "Check":<34}{ "Full line":>12}{ "Scan":>12}' )
+  for line_name, pattern in LINES.items():
+    line = GenerateLine( pattern, args.length )
+    with patch( 'ycm.vimsupport.CurrentLineContents', return_value = line ), \
+         patch( 'ycm.vimsupport.CurrentColumn',
+                return_value = len( ToBytes( line ) ) ), \
+         patch( 'ycm.vimsupport.CurrentFiletypes',
+                return_value = [ 'javascript' ] ):
+      # Compute the offsets of the line once for all the checks.
+      vimsupport.CurrentLineContentsAndCodepointColumn()
+      for check_name, full_line_check, check in CHECKS:
+        assert full_line_check() == check()
+        full_line_seconds = Measure( full_line_check, args.repeat )
+        seconds = Measure( check, args.repeat )
+        print( f'{ line_name:<22}{ check_name:<34}'
+               f'{ full_line_seconds * 1e6:>9.1f} us'
+               f'{ seconds * 1e6:>9.1f} us' )
+
+
+if __name__ == '__main__':
+  Main()
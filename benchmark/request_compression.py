@@ -0,0 +1,151 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Measures the end-to-end latency of a FileReadyToParse request with and
+without compression of the request body for various buffer sizes, to tune
+g:ycm_compress_requests_larger_than_kb. The requests are sent to a local stub
+server that decompresses and parses the body like ycmd would. The bandwidth
+between the client and the server can be limited to simulate a remote
+server."""
+
+import argparse
+import json
+import os
+import os.path as p
+import statistics
+import sys
+import threading
+import time
+import zlib
+from base64 import b64encode
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+DIR_OF_THIS_SCRIPT = p.dirname( p.abspath( __file__ ) )
+sys.path[ 0 : 0 ] = [ p.join( DIR_OF_THIS_SCRIPT, '..', 'python' ),
+                      p.join( DIR_OF_THIS_SCRIPT, '..', 'third_party',
+                              'ycmd' ) ]
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+from ycm.client.base_request import BaseRequest
+from ycmd.hmac_utils import CreateHmac
+
+HMAC_SECRET = os.urandom( 16 )
+BUFFER_SIZES_KB = [ 16, 64, 256, 1024, 4096, 16384 ]
+SOURCE_LINE = 'static int generated_{0} = Compute( "value {0}", {0} );\n'
+
+
+def GenerateBuffer( size_kb ):
+  lines = []
+  size = 0
+  while size < size_kb * 1024:
+    lines.append( SOURCE_LINE.format( len( lines ) ) )
+    size += len( lines[ -1 ] )
+  return ''.join( lines )
+
+
+class StubServerHandler( BaseHTTPRequestHandler ):
+  protocol_version = 'HTTP/1.1'
+  bytes_per_second = None
+
+
+  def _Throttle( self, size ):
+    if self.bytes_per_second:
+      time.sleep( size / self.bytes_per_second )
+
+
+  def do_POST( self ):
+    body = self.rfile.read( int( self.headers[ 'content-length' ] ) )
+    self._Throttle( len( body ) )
+    if self.headers.get( 'content-encoding' ) == 'deflate':
+      body = zlib.decompress( body )
+    if body:
+      json.loads( body )
+
+    response = b'[]'
+    self.send_response( 200 )
+    self.send_header( 'accept-encoding', 'deflate' )
+    self.send_header( 'content-length', str( len( response ) ) )
+    response_hmac = b64encode( CreateHmac( response, HMAC_SECRET ) )
+    self.send_header( 'x-ycm-hmac', response_hmac.decode() )
+    self.end_headers()
+    self.wfile.write( response )
+
+
+  def log_message( self, *args ):
+    pass
+
+
+def MeasureLatency( request_data, compression_threshold, repeat ):
+  BaseRequest.compression_threshold = compression_threshold
+  # Negotiate the encoding before measuring.
+  BaseRequest().PostDataToHandler( {}, 'event_notification' )
+
+  latencies = []
+  for _ in range( repeat ):
+    start_time = time.perf_counter()
+    BaseRequest().PostDataToHandler( request_data, 'event_notification' )
+    latencies.append( time.perf_counter() - start_time )
+  return statistics.median( latencies )
+
+
+def ParseArguments():
+  parser = argparse.ArgumentParser( description = __doc__ )
+  parser.add_argument( '--repeat', type = int, default = 10,
+                       help = 'Number of requests sent per measurement.' )
+  parser.add_argument( '--bandwidth-mbps', type = float,
+                       help = 'Simulated bandwidth to the server in megabits '
+                              'per second. Unlimited by default.' )
+  return parser.parse_args()
+
+
+def Main():
+  args = ParseArguments()
+  if args.bandwidth_mbps:
+    StubServerHandler.bytes_per_second = args.bandwidth_mbps * 1000000 / 8
+
+  server = ThreadingHTTPServer( ( '127.0.0.1', 0 ), StubServerHandler )
+  threading.Thread( target = server.serve_forever, daemon = True ).start()
+  BaseRequest.server_location = f'http://127.0.0.1:{ server.server_port }'
+  BaseRequest.hmac_secret = HMAC_SECRET
+
+  print( f'{ "Buffer size":>12} { "Raw":>10} { "Deflate":>10} { "Ratio":>7}' )
+  for size_kb in BUFFER_SIZES_KB:
+    request_data = {
+      'filepath': '/generated.cc',
+      'line_num': 1,
+      'column_num': 1,
+      'event_name': 'FileReadyToParse',
+      'file_data': {
+        '/generated.cc': {
+          'contents': GenerateBuffer( size_kb ),
+          'filetypes': [ 'cpp' ]
+        }
+      }
+    }
+    raw = MeasureLatency( request_data, 0, args.repeat )
+    compressed = MeasureLatency( request_data, 1, args.repeat )
+    print( f'{ size_kb:>9} KB { raw * 1000:>7.1f} ms '
+           f'{ compressed * 1000:>7.1f} ms { compressed / raw:>7.2f}' )
+
+  server.shutdown()
+
+
+if __name__ == '__main__':
+  Main()
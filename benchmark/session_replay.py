@@ -0,0 +1,491 @@
+#!/usr/bin/env python3
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+"""Records an editing session then replays it to measure the performance of
+the client.
+
+The record command runs Vim in a pseudo-terminal and logs the keys typed with
+their timing. YCM attaches to a proxy that forwards its requests to a real ycmd
+server and logs them along with the responses and their latencies.
+
+The replay command types the same keys with the same timing in Vim, without a
+terminal, while YCM attaches to a stub server that answers each request with
+the response recorded for the same handler, after the recorded latency. It
+then reports the CPU time used by Vim, the latency between typing and the
+completion menu being shown, and the number of calls from Python to Vim."""
+
+import argparse
+import base64
+import fcntl
+import json
+import os
+import os.path as p
+import pty
+import select
+import shutil
+import signal
+import socket
+import statistics
+import struct
+import subprocess
+import sys
+import tempfile
+import termios
+import threading
+import time
+import tty
+from collections import defaultdict, deque
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+from urllib.error import HTTPError
+from urllib.parse import urlparse
+from urllib.request import Request, urlopen
+
+DIR_OF_THIS_SCRIPT = p.dirname( p.abspath( __file__ ) )
+DIR_OF_YCMD = p.join( DIR_OF_THIS_SCRIPT, '..', 'third_party', 'ycmd' )
+sys.path[ 0 : 0 ] = [ p.join( DIR_OF_THIS_SCRIPT, '..', 'python' ),
+                      DIR_OF_YCMD ]
+
+from ycm import shared_server
+from ycmd.hmac_utils import CreateHmac
+
+VIMRC = p.join( DIR_OF_THIS_SCRIPT, 'session_replay.vim' )
+SESSION_FILE = 'session.json'
+KEYS_FILE = 'keys.jsonl'
+EXCHANGES_FILE = 'exchanges.jsonl'
+HMAC_HEADER = 'x-ycm-hmac'
+HMAC_SECRET_LENGTH = 16
+# The stub server always answers these handlers positively.
+LIFECYCLE_HANDLERS = { 'ready', 'healthy', 'shutdown' }
+# Headers forwarded by the recording proxy. Compression is left out so that
+# the recorded bodies are plain JSON.
+FORWARDED_HEADERS = [ 'content-type', HMAC_HEADER ]
+SERVER_START_TIMEOUT_SEC = 30
+VIM_EXIT_TIMEOUT_SEC = 10
+
+
+def Handler( path ):
+  return urlparse( path ).path.lstrip( '/' )
+
+
+def WriteJsonLines( filepath, records ):
+  with open( filepath, 'w' ) as lines_file:
+    for record in records:
+      lines_file.write( json.dumps( record ) + '\n' )
+
+
+def ReadJsonLines( filepath ):
+  with open( filepath ) as lines_file:
+    return [ json.loads( line ) for line in lines_file if line.strip() ]
+
+
+class RecordingProxyHandler( BaseHTTPRequestHandler ):
+  """Forwards the requests to the ycmd server at |server_location| and logs
+  them in |exchanges|. Both sides use the same HMAC secret so the requests and
+  responses are forwarded as is."""
+
+  server_location = None
+  exchanges = []
+
+  def _Forward( self ):
+    length = int( self.headers.get( 'content-length', 0 ) )
+    body = self.rfile.read( length ) if length else None
+    headers = { name: self.headers[ name ] for name in FORWARDED_HEADERS
+                if name in self.headers }
+    start_time = time.monotonic()
+    try:
+      response = urlopen( Request( self.server_location + self.path,
+                                   data = body,
+                                   headers = headers,
+                                   method = self.command ) )
+    except HTTPError as error:
+      response = error
+    response_body = response.read()
+    seconds = time.monotonic() - start_time
+
+    self.exchanges.append( {
+      'handler': Handler( self.path ),
+      'method': self.command,
+      'request': json.loads( body ) if body else None,
+      'status': response.status,
+      'response': response_body.decode( 'utf-8' ),
+      'seconds': seconds
+    } )
+    self.send_response( response.status )
+    for name in FORWARDED_HEADERS:
+      if response.headers.get( name ):
+        self.send_header( name, response.headers[ name ] )
+    self.send_header( 'content-length', str( len( response_body ) ) )
+    self.end_headers()
+    self.wfile.write( response_body )
+
+
+  do_GET = _Forward
+  do_POST = _Forward
+
+
+  def log_message( self, *args ):
+    pass
+
+
+class StubServerHandler( BaseHTTPRequestHandler ):
+  """Answers each request with the next response recorded for its handler,
+  after the recorded latency. The last response is repeated once all of them
+  were served."""
+
+  hmac_secret = None
+  responses = defaultdict( deque )
+  served_requests = defaultdict( int )
+
+  def _Answer( self ):
+    length = int( self.headers.get( 'content-length', 0 ) )
+    if length:
+      self.rfile.read( length )
+    handler = Handler( self.path )
+    self.served_requests[ handler ] += 1
+
+    if handler in LIFECYCLE_HANDLERS:
+      status, body = 200, 'true'
+    elif self.responses[ handler ]:
+      responses = self.responses[ handler ]
+      exchange = responses.popleft() if len( responses ) > 1 else responses[ 0 ]
+      time.sleep( exchange[ 'seconds' ] )
+      status, body = exchange[ 'status' ], exchange[ 'response' ]
+    else:
+      status, body = 200, 'null'
+
+    body = body.encode( 'utf-8' )
+    self.send_response( status )
+    self.send_header( 'content-type', 'application/json' )
+    self.send_header( 'content-length', str( len( body ) ) )
+    self.send_header( HMAC_HEADER, base64.b64encode(
+      CreateHmac( body, self.hmac_secret ) ).decode() )
+    self.end_headers()
+    self.wfile.write( body )
+
+
+  do_GET = _Answer
+  do_POST = _Answer
+
+
+  def log_message( self, *args ):
+    pass
+
+
+def StartHttpServer( handler_class ):
+  server = ThreadingHTTPServer( ( '127.0.0.1', 0 ), handler_class )
+  server.daemon_threads = True
+  threading.Thread( target = server.serve_forever, daemon = True ).start()
+  return server, f'http://127.0.0.1:{ server.server_port }'
+
+
+def UnusedLocalPort():
+  with socket.socket() as sock:
+    sock.bind( ( '127.0.0.1', 0 ) )
+    return sock.getsockname()[ 1 ]
+
+
+def StartYcmd( hmac_secret, log_dir ):
+  with open( p.join( DIR_OF_YCMD, 'ycmd', 'default_settings.json' ) ) as f:
+    options = json.load( f )
+  options[ 'hmac_secret' ] = base64.b64encode( hmac_secret ).decode()
+  # ycmd deletes the options file once it has read it.
+  with tempfile.NamedTemporaryFile( 'w', suffix = '.json',
+                                    delete = False ) as options_file:
+    json.dump( options, options_file )
+
+  port = UnusedLocalPort()
+  ycmd = subprocess.Popen( [ sys.executable,
+                             p.join( DIR_OF_YCMD, 'ycmd' ),
+                             f'--port={ port }',
+                             f'--options_file={ options_file.name }',
+                             f'--stdout={ p.join( log_dir, "ycmd_stdout" ) }',
+                             f'--stderr={ p.join( log_dir, "ycmd_stderr" ) }',
+                             '--keep_logfiles' ] )
+  location = f'http://127.0.0.1:{ port }'
+  deadline = time.monotonic() + SERVER_START_TIMEOUT_SEC
+  while time.monotonic() < deadline:
+    try:
+      with socket.create_connection( ( '127.0.0.1', port ), timeout = 1 ):
+        return ycmd, location
+    except OSError:
+      time.sleep( 0.1 )
+  ycmd.terminate()
+  sys.exit( 'ycmd did not start. Is it built?' )
+
+
+def PublishServer( runtime_dir, location, hmac_secret, log_dir ):
+  """Makes YCM in the Vim started with VimEnvironment( runtime_dir, ... )
+  attach to the server at |location|."""
+  shared_server.PublishServerState(
+    location,
+    hmac_secret,
+    os.getpid(),
+    [ p.join( log_dir, 'ycmd_stdout' ), p.join( log_dir, 'ycmd_stderr' ) ],
+    state_dir = p.join( runtime_dir, shared_server.STATE_DIRNAME ) )
+
+
+def VimEnvironment( runtime_dir, benchmark_dir ):
+  """Returns the environment of a Vim that looks up the shared server in
+  |runtime_dir| and writes the statistics of YCM in |benchmark_dir|."""
+  env = dict( os.environ )
+  env[ 'XDG_RUNTIME_DIR' ] = runtime_dir
+  env[ 'YCM_BENCHMARK_DIR' ] = benchmark_dir
+  return env
+
+
+def SpawnVim( vim, files, env, rows, columns ):
+  pid, master_fd = pty.fork()
+  if pid == 0:
+    fcntl.ioctl( sys.stdin.fileno(), termios.TIOCSWINSZ,
+                 struct.pack( 'HHHH', rows, columns, 0, 0 ) )
+    os.execvpe( vim, [ vim, '-N', '-i', 'NONE', '-u', VIMRC ] + files, env )
+  return pid, master_fd
+
+
+def WaitForVim( pid, master_fd ):
+  """Waits for Vim to exit, quitting it if it takes too long. Returns the
+  resource usage of the Vim process."""
+  deadline = time.monotonic() + VIM_EXIT_TIMEOUT_SEC
+  quit_sent = False
+  while True:
+    exited_pid, _, rusage = os.wait4( pid, os.WNOHANG )
+    if exited_pid:
+      return rusage
+    if time.monotonic() > deadline:
+      if quit_sent:
+        os.kill( pid, signal.SIGKILL )
+      else:
+        os.write( master_fd, b'\x1b\x1b:qa!\r' )
+        quit_sent = True
+        deadline += VIM_EXIT_TIMEOUT_SEC
+    time.sleep( 0.05 )
+
+
+def Record( args ):
+  os.makedirs( args.session_dir, exist_ok = True )
+  # Private to the current user, as required for the shared server state.
+  runtime_dir = tempfile.mkdtemp( prefix = 'ycm_record_' )
+  try:
+    hmac_secret = os.urandom( HMAC_SECRET_LENGTH )
+    ycmd, ycmd_location = StartYcmd( hmac_secret, args.session_dir )
+    RecordingProxyHandler.server_location = ycmd_location
+    proxy, proxy_location = StartHttpServer( RecordingProxyHandler )
+    PublishServer( runtime_dir, proxy_location, hmac_secret, args.session_dir )
+
+    columns, rows = shutil.get_terminal_size()
+    # The statistics of the recorded session are kept with it.
+    pid, master_fd = SpawnVim( args.vim,
+                               args.files,
+                               VimEnvironment( runtime_dir, args.session_dir ),
+                               rows,
+                               columns )
+    keys = RelayTerminal( master_fd )
+    WaitForVim( pid, master_fd )
+
+    proxy.shutdown()
+    ycmd.terminate()
+  finally:
+    shutil.rmtree( runtime_dir, ignore_errors = True )
+
+  with open( p.join( args.session_dir, SESSION_FILE ), 'w' ) as session_file:
+    json.dump( { 'files': args.files, 'rows': rows, 'columns': columns },
+               session_file )
+  WriteJsonLines( p.join( args.session_dir, KEYS_FILE ), keys )
+  WriteJsonLines( p.join( args.session_dir, EXCHANGES_FILE ),
+                  RecordingProxyHandler.exchanges )
+  print( f'Recorded { len( keys ) } inputs and '
+         f'{ len( RecordingProxyHandler.exchanges ) } requests in '
+         f'{ args.session_dir }' )
+
+
+def RelayTerminal( master_fd ):
+  """Relays the terminal to Vim until it exits and returns the keys typed,
+  with the delay since the previous keys."""
+  keys = []
+  stdin_fd = sys.stdin.fileno()
+  terminal_attributes = termios.tcgetattr( stdin_fd )
+  tty.setraw( stdin_fd )
+  last_input_time = time.monotonic()
+  try:
+    while True:
+      readable, _, _ = select.select( [ stdin_fd, master_fd ], [], [] )
+      if stdin_fd in readable:
+        data = os.read( stdin_fd, 1024 )
+        now = time.monotonic()
+        keys.append( { 'delay': now - last_input_time,
+                       'keys': data.decode( 'latin-1' ) } )
+        last_input_time = now
+        os.write( master_fd, data )
+      if master_fd in readable:
+        try:
+          data = os.read( master_fd, 65536 )
+        except OSError:
+          break
+        if not data:
+          break
+        os.write( sys.stdout.fileno(), data )
+  finally:
+    termios.tcsetattr( stdin_fd, termios.TCSAFLUSH, terminal_attributes )
+  return keys
+
+
+def DrainOutput( master_fd ):
+  try:
+    while os.read( master_fd, 65536 ):
+      pass
+  except OSError:
+    pass
+
+
+def Replay( args ):
+  with open( p.join( args.session_dir, SESSION_FILE ) ) as session_file:
+    session = json.load( session_file )
+  keys = ReadJsonLines( p.join( args.session_dir, KEYS_FILE ) )
+  for exchange in ReadJsonLines( p.join( args.session_dir, EXCHANGES_FILE ) ):
+    StubServerHandler.responses[ exchange[ 'handler' ] ].append( exchange )
+
+  runtime_dir = tempfile.mkdtemp( prefix = 'ycm_replay_' )
+  benchmark_dir = tempfile.mkdtemp( prefix = 'ycm_replay_results_' )
+  try:
+    StubServerHandler.hmac_secret = os.urandom( HMAC_SECRET_LENGTH )
+    stub, stub_location = StartHttpServer( StubServerHandler )
+    PublishServer( runtime_dir, stub_location, StubServerHandler.hmac_secret,
+                   benchmark_dir )
+
+    pid, master_fd = SpawnVim( args.vim,
+                               session[ 'files' ],
+                               VimEnvironment( runtime_dir, benchmark_dir ),
+                               session[ 'rows' ],
+                               session[ 'columns' ] )
+    threading.Thread( target = DrainOutput,
+                      args = ( master_fd, ),
+                      daemon = True ).start()
+    for key in keys:
+      time.sleep( key[ 'delay' ] )
+      os.write( master_fd, key[ 'keys' ].encode( 'latin-1' ) )
+    rusage = WaitForVim( pid, master_fd )
+    stub.shutdown()
+
+    results = Results( rusage, benchmark_dir )
+  finally:
+    shutil.rmtree( runtime_dir, ignore_errors = True )
+    shutil.rmtree( benchmark_dir, ignore_errors = True )
+
+  if args.json:
+    print( json.dumps( results, indent = 2 ) )
+  else:
+    PrintResults( results )
+
+
+def Results( rusage, benchmark_dir ):
+  results = {
+    'cpu_seconds': {
+      'user': rusage.ru_utime,
+      'system': rusage.ru_stime
+    },
+    'requests': dict( StubServerHandler.served_requests )
+  }
+
+  try:
+    with open( p.join( benchmark_dir, 'pum_latencies.json' ) ) as f:
+      latencies = json.load( f )
+  except ( OSError, ValueError ):
+    latencies = []
+  if latencies:
+    latencies.sort()
+    results[ 'pum_latency_ms' ] = {
+      'count': len( latencies ),
+      'median': statistics.median( latencies ) * 1000,
+      'p90': latencies[ int( 0.9 * ( len( latencies ) - 1 ) ) ] * 1000,
+      'max': latencies[ -1 ] * 1000
+    }
+
+  try:
+    stats = ReadJsonLines( p.join( benchmark_dir, 'stats.jsonl' ) )[ -1 ]
+  except ( OSError, ValueError, IndexError ):
+    stats = None
+  if stats:
+    results[ 'bridge_calls' ] = {
+      kind: stats[ 'stats' ].get( f'vim_{ kind }_calls', {} )
+      for kind in [ 'eval', 'command' ] }
+  return results
+
+
+def PrintResults( results ):
+  cpu_seconds = results[ 'cpu_seconds' ]
+  print( f'Vim CPU time: '
+         f'{ cpu_seconds[ "user" ] + cpu_seconds[ "system" ]:.3f} s '
+         f'(user { cpu_seconds[ "user" ]:.3f} s, '
+         f'system { cpu_seconds[ "system" ]:.3f} s)' )
+
+  pum_latency = results.get( 'pum_latency_ms' )
+  if pum_latency:
+    print( f'Keystroke to completion menu: { pum_latency[ "count" ] } menus, '
+           f'median { pum_latency[ "median" ]:.1f} ms, '
+           f'p90 { pum_latency[ "p90" ]:.1f} ms, '
+           f'max { pum_latency[ "max" ]:.1f} ms' )
+  else:
+    print( 'Keystroke to completion menu: no menu shown' )
+
+  bridge_calls = results.get( 'bridge_calls' )
+  if bridge_calls:
+    for kind, calls in bridge_calls.items():
+      print( f'vim.{ kind } calls: { sum( calls.values() ) }' )
+      for subsystem, count in sorted( calls.items(),
+                                      key = lambda item: -item[ 1 ] ):
+        print( f'  { subsystem }: { count }' )
+  else:
+    print( 'vim.eval and vim.command calls: unknown, YCM did not write its '
+           'statistics' )
+
+  print( f'Requests: { sum( results[ "requests" ].values() ) }' )
+
+
+def ParseArguments():
+  parser = argparse.ArgumentParser(
+    description = __doc__,
+    formatter_class = argparse.RawDescriptionHelpFormatter )
+  parser.add_argument( '--vim', default = 'vim',
+                       help = 'Vim executable to run.' )
+  subparsers = parser.add_subparsers( dest = 'command', required = True )
+
+  record_parser = subparsers.add_parser(
+    'record', help = 'Record a session with a real ycmd server.' )
+  record_parser.add_argument( 'session_dir',
+                              help = 'Directory where the session is saved.' )
+  record_parser.add_argument( 'files', nargs = '*',
+                              help = 'Files to edit.' )
+  record_parser.set_defaults( run = Record )
+
+  replay_parser = subparsers.add_parser(
+    'replay', help = 'Replay a session against a stub server.' )
+  replay_parser.add_argument( 'session_dir',
+                              help = 'Directory of the recorded session.' )
+  replay_parser.add_argument( '--json', action = 'store_true',
+                              help = 'Print the results as JSON.' )
+  replay_parser.set_defaults( run = Replay )
+  return parser.parse_args()
+
+
+def Main():
+  args = ParseArguments()
+  args.run( args )
+
+
+if __name__ == '__main__':
+  Main()
@@ -0,0 +1,53 @@
+" Copyright (C) 2026 YouCompleteMe contributors
+"
+" This file is part of YouCompleteMe.
+"
+" YouCompleteMe is free software: you can redistribute it and/or modify
+" it under the terms of the GNU General Public License as published by
+" the Free Software Foundation, either version 3 of the License, or
+" (at your option) any later version.
+"
+" YouCompleteMe is distributed in the hope that it will be useful,
+" but WITHOUT ANY WARRANTY; without even the implied warranty of
+" MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+" GNU General Public License for more details.
+"
+" You should have received a copy of the GNU General Public License
+" along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+" The vimrc used by session_replay.py, both when recording and when replaying a
+" session, so that Vim behaves the same way in both cases. YCM attaches to the
+" server published by session_replay.py through the shared server mechanism.
+
+set nocompatible
+let &runtimepath = expand( '<sfile>:p:h:h' ) . ',' . &runtimepath
+filetype plugin indent on
+syntax enable
+set shortmess+=c
+set noswapfile
+
+let g:ycm_shared_server = 1
+let g:ycm_confirm_extra_conf = 0
+let g:ycm_stats_file = $YCM_BENCHMARK_DIR . '/stats.jsonl'
+let g:ycm_count_vim_calls = 1
+
+" Seconds between a change of the text in insert mode and the completion menu
+" being shown or updated.
+let s:pum_latencies = []
+let s:last_change_time = v:null
+
+function! s:RecordPumLatency()
+  if s:last_change_time isnot v:null
+    call add( s:pum_latencies, reltimefloat( reltime( s:last_change_time ) ) )
+    let s:last_change_time = v:null
+  endif
+endfunction
+
+augroup YcmSessionReplay
+  autocmd!
+  autocmd TextChangedI,TextChangedP * let s:last_change_time = reltime()
+  autocmd CompleteChanged * call s:RecordPumLatency()
+  autocmd VimLeavePre * call writefile(
+        \ [ json_encode( s:pum_latencies ) ],
+        \ $YCM_BENCHMARK_DIR . '/pum_latencies.json' )
+augroup END
@@ -192,12 +192,36 @@ let g:ycm_goto_buffer_command =
 let g:ycm_disable_for_files_larger_than_kb =
       \ get( g:, 'ycm_disable_for_files_larger_than_kb', 1000 )
 
+let g:ycm_large_file_mode =
+      \ get( g:, 'ycm_large_file_mode', 0 )
+
 let g:ycm_auto_hover =
       \ get( g:, 'ycm_auto_hover', 'CursorHold' )
 
 let g:ycm_update_diagnostics_in_insert_mode =
       \ get( g:, 'ycm_update_diagnostics_in_insert_mode', 1 )
 
+let g:ycm_shared_server =
+      \ get( g:, 'ycm_shared_server', 0 )
+
+let g:ycm_server_standby =
+      \ get( g:, 'ycm_server_standby', 0 )
+
+let g:ycm_server_auto_restart =
+      \ get( g:, 'ycm_server_auto_restart', 1 )
+
+let g:ycm_prefetch_buffers =
+      \ get( g:, 'ycm_prefetch_buffers', 0 )
+
+let g:ycm_compress_requests_larger_than_kb =
+      \ get( g:, 'ycm_compress_requests_larger_than_kb', 0 )
+
+let g:ycm_stats_file =
+      \ get( g:, 'ycm_stats_file', '' )
+
+let g:ycm_count_vim_calls =
+      \ get( g:, 'ycm_count_vim_calls', 0 )
+
 "
 " List of ycmd options.
 "
@@ -17,48 +17,93 @@
 
 import os
 import json
+import re
+from collections.abc import Mapping
 
 from ycm import vimsupport, paths
 from ycmd import identifier_utils
 
 YCM_VAR_PREFIX = 'ycm_'
 
+# The identifier checks done on each keystroke only look at this many
+# characters before the cursor so that they don't slow down on long lines, like
+# minified or generated code. Longer identifiers are still detected unless
+# their last characters can't start one (e.g. digits).
+MAX_IDENTIFIER_SCAN_LENGTH = 100
+NON_WHITESPACE_REGEX = re.compile( r'\S' )
+
+# The server defaults don't change while Vim is running so they are only read
+# once.
+_server_default_options = None
+
+
+class Options( Mapping ):
+  """Read-only snapshot of the YCM options built by GetUserOptions. Options are
+  stored as attributes so that code called on every keystroke or cursor move
+  can read them as |options.name| instead of doing a dictionary lookup. The
+  mapping interface is kept for the code that needs all the options at once.
+  Use :YcmReloadOptions to take a new snapshot after changing an option."""
+
+  def __init__( self, options ):
+    self.__dict__.update( options )
+
+
+  def __setattr__( self, name, value ):
+    raise AttributeError( f'Cannot set option { name }: options are read-only' )
+
+
+  def __delattr__( self, name ):
+    raise AttributeError( f'Cannot unset option { name }: options are '
+                          'read-only' )
+
+
+  def __getitem__( self, key ):
+    return self.__dict__[ key ]
 
-def GetUserOptions( default_options = {} ):
-  """Builds a dictionary mapping YCM Vim user options to values. Option names
-  don't have the 'ycm_' prefix."""
 
-  user_options = {}
+  def __iter__( self ):
+    return iter( self.__dict__ )
+
+
+  def __len__( self ):
+    return len( self.__dict__ )
+
+
+  def __repr__( self ):
+    return f'Options({ self.__dict__ })'
+
+
+def _ServerDefaultOptions():
+  global _server_default_options
+  if _server_default_options is None:
+    _server_default_options = {}
+    defaults_file =  os.path.join( paths.DIR_OF_YCMD,
+                                   'ycmd',
+                                   'default_settings.json' )
+    if os.path.exists( defaults_file ):
+      with open( defaults_file ) as defaults_file_handle:
+        _server_default_options = json.load( defaults_file_handle )
+  return _server_default_options
+
+
+def GetUserOptions( default_options = {} ):
+  """Builds an Options snapshot mapping YCM Vim user options to values. Option
+  names don't have the 'ycm_' prefix."""
 
   # First load the default settings from ycmd. We do this to ensure that any
   # client-side code that assumes all options are loaded (such as the
   # omnicompleter) don't have to constantly check for values being present, and
   # so that we don't jave to dulicate the list of server settings in
   # youcomplete.vim
-  defaults_file =  os.path.join( paths.DIR_OF_YCMD,
-                                 'ycmd',
-                                 'default_settings.json' )
-  if os.path.exists( defaults_file ):
-    with open( defaults_file ) as defaults_file_handle:
-      user_options = json.load( defaults_file_handle )
+  user_options = dict( _ServerDefaultOptions() )
 
   # Override the server defaults with any client-generated defaults
   user_options.update( default_options )
 
   # Finally, override with any user-specified values in the g: dict
+  user_options.update( vimsupport.GetVimGlobalsWithPrefix( YCM_VAR_PREFIX ) )
 
-  # We only evaluate the keys of the vim globals and not the whole dictionary
-  # to avoid unicode issues.
-  # See https://github.com/Valloric/YouCompleteMe/pull/2151 for details.
-  keys = vimsupport.GetVimGlobalsKeys()
-  for key in keys:
-    if not key.startswith( YCM_VAR_PREFIX ):
-      continue
-    new_key = key[ len( YCM_VAR_PREFIX ): ]
-    new_value = vimsupport.VimExpressionToPythonType( 'g:' + key )
-    user_options[ new_key ] = new_value
-
-  return user_options
+  return Options( user_options )
 
 
 def CurrentIdentifierFinished():
@@ -69,12 +114,15 @@ def CurrentIdentifierFinished():
   filetype = vimsupport.CurrentFiletypes()[ 0 ]
   regex = identifier_utils.IdentifierRegexForFiletype( filetype )
 
-  for match in regex.finditer( line ):
+  # Only look for an identifier ending just before the last entered character
+  # in the text preceding it instead of the whole line.
+  start = max( previous_char_index - MAX_IDENTIFIER_SCAN_LENGTH, 0 )
+  for match in regex.finditer( line, start, current_column ):
     if match.end() == previous_char_index:
       return True
   # If the whole line is whitespace, that means the user probably finished an
   # identifier on the previous line.
-  return line[ : current_column ].isspace()
+  return NON_WHITESPACE_REGEX.search( line, 0, current_column ) is None
 
 
 def LastEnteredCharIsIdentifierChar():
@@ -82,9 +130,11 @@ def LastEnteredCharIsIdentifierChar():
   if current_column - 1 < 0:
     return False
   filetype = vimsupport.CurrentFiletypes()[ 0 ]
+  start = max( current_column - MAX_IDENTIFIER_SCAN_LENGTH, 0 )
   return (
     identifier_utils.StartOfLongestIdentifierEndingAtIndex(
-        line, current_column, filetype ) != current_column )
+        line[ start : current_column ], current_column - start, filetype ) !=
+    current_column - start )
 
 
 def AdjustCandidateInsertionText( candidates ):
@@ -15,11 +15,29 @@
 # You should have received a copy of the GNU General Public License
 # along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
 
+import sys
+from collections import OrderedDict
 from ycm import vimsupport
 from ycm.client.event_notification import EventNotification
 from ycm.diagnostic_interface import DiagnosticInterface
-from ycm.semantic_highlighting import SemanticHighlighting
-from ycm.inlay_hints import InlayHints
+
+# Number of buffers not displayed in any window for which the diagnostics are
+# kept. Past that, the least recently used hidden buffers are dropped and
+# recreated empty if they are visited again; the next parse request brings
+# their diagnostics back. They are dropped by batches, once that many more
+# buffers are tracked, so that the displayed buffers are only looked up from
+# time to time.
+MAX_HIDDEN_BUFFERS = 100
+EVICTION_BATCH_SIZE = 25
+
+# Parse requests are delayed by a fraction of the smoothed duration of the
+# previous parses of the buffer so that edits made while the server would be
+# busy parsing are coalesced into a single request. Buffers that parse quickly
+# are not delayed at all.
+PARSE_DURATION_SMOOTHING_FACTOR = 0.25
+PARSE_DELAY_FACTOR = 0.5
+MIN_PARSE_DELAY_SECONDS = 0.05
+MAX_PARSE_DELAY_SECONDS = 2
 
 
 # Emulates Vim buffer
@@ -34,20 +52,64 @@ class Buffer:
     self._handled_tick = 0
     self._parse_request = None
     self._should_resend = False
-    self._diag_interface = DiagnosticInterface( bufnr, user_options )
-    self._open_loclist_on_ycm_diags = user_options[
-                                        'open_loclist_on_ycm_diags' ]
-    self.semantic_highlighting = SemanticHighlighting( bufnr )
-    self.inlay_hints = InlayHints( bufnr )
+    self._parse_seconds = None
+    self._parse_duration_recorded = False
+    self._prefetched = False
+    self._user_options = user_options
+    self._diag_interface = None
+    self._open_loclist_on_ycm_diags = user_options.open_loclist_on_ycm_diags
+    self._semantic_highlighting = None
+    self._inlay_hints = None
     self.UpdateFromFileTypes( filetypes )
 
 
+  # Semantic highlighting and inlay hints are disabled by default so their
+  # modules are only imported when a buffer actually uses them.
+  @property
+  def semantic_highlighting( self ):
+    if self._semantic_highlighting is None:
+      from ycm.semantic_highlighting import SemanticHighlighting
+      self._semantic_highlighting = SemanticHighlighting( self._number )
+    return self._semantic_highlighting
+
+
+  @property
+  def inlay_hints( self ):
+    if self._inlay_hints is None:
+      from ycm.inlay_hints import InlayHints
+      self._inlay_hints = InlayHints( self._number )
+    return self._inlay_hints
+
+
+  # Most buffers never receive a diagnostic (e.g. buffers opened by a plugin or
+  # files without a semantic completer) so the diagnostic interface is only
+  # created when needed.
+  @property
+  def diag_interface( self ):
+    if self._diag_interface is None:
+      self._diag_interface = DiagnosticInterface( self._number,
+                                                  self._user_options )
+    return self._diag_interface
+
+
+  def UpdateOptions( self, user_options ):
+    self._user_options = user_options
+    if self._diag_interface is not None:
+      self._diag_interface.UpdateOptions( user_options )
+    self._open_loclist_on_ycm_diags = user_options.open_loclist_on_ycm_diags
+
+
   def FileParseRequestReady( self, block = False ):
     return ( bool( self._parse_request ) and
              ( block or self._parse_request.Done() ) )
 
 
-  def SendParseRequest( self, extra_data ):
+  def SendParseRequest( self, extra_data, prefetch = False, on_success = None ):
+    """Sends a parse request for this buffer. If |prefetch| is True, the buffer
+    is not the current one; the response is handled when the buffer is entered
+    (see UsePrefetchedParse). |on_success| is called once the server answered
+    the request without error; it is never called if the request isn't sent
+    because another one is in progress."""
     # Don't send a parse request if one is in progress
     if self._parse_request is not None and not self._parse_request.Done():
       self._should_resend = True
@@ -55,13 +117,66 @@ class Buffer:
 
     self._should_resend = False
 
-    self._parse_request = EventNotification( 'FileReadyToParse',
-                                             extra_data = extra_data )
+    self._RecordParseDuration()
+    self._parse_duration_recorded = False
+    self._parse_request = EventNotification(
+      'FileReadyToParse',
+      buffer_number = self._number if prefetch else None,
+      extra_data = extra_data,
+      on_success = on_success )
     self._parse_request.Start()
     # Decrement handled tick to ensure correct handling when we are forcing
     # reparse on buffer visit and changed tick remains the same.
     self._handled_tick -= 1
     self._parse_tick = self._ChangedTick()
+    self._prefetched = prefetch
+
+
+  def IsPrefetched( self ):
+    """Returns whether the last parse request was sent while the buffer was
+    hidden and the buffer didn't change since."""
+    return self._prefetched and not self.NeedsReparse()
+
+
+  def UsePrefetchedParse( self ):
+    """Returns whether the prefetched parse can be used instead of parsing the
+    buffer again when entering it. It is only used once since other buffers may
+    have changed in the meantime."""
+    prefetched = self.IsPrefetched()
+    self._prefetched = False
+    return prefetched
+
+
+  def ParseRequestDuration( self ):
+    if self._parse_request is None:
+      return None
+    return self._parse_request.Duration()
+
+
+  def ParseDelay( self ):
+    """Returns the number of milliseconds to wait before sending a parse
+    request after the buffer changed."""
+    self._RecordParseDuration()
+    if self._parse_seconds is None:
+      return 0
+    delay = self._parse_seconds * PARSE_DELAY_FACTOR
+    if delay < MIN_PARSE_DELAY_SECONDS:
+      return 0
+    return int( min( delay, MAX_PARSE_DELAY_SECONDS ) * 1000 )
+
+
+  def _RecordParseDuration( self ):
+    if self._parse_request is None or self._parse_duration_recorded:
+      return
+    parse_seconds = self._parse_request.Duration()
+    if parse_seconds is None:
+      return
+    self._parse_duration_recorded = True
+    if self._parse_seconds is None:
+      self._parse_seconds = parse_seconds
+    else:
+      self._parse_seconds += PARSE_DURATION_SMOOTHING_FACTOR * (
+        parse_seconds - self._parse_seconds )
 
 
   def ParseRequestPending( self ):
@@ -90,17 +205,17 @@ class Buffer:
 
   def UpdateWithNewDiagnostics( self, diagnostics, async_message ):
     self._async_diags = async_message
-    self._diag_interface.UpdateWithNewDiagnostics(
+    self.diag_interface.UpdateWithNewDiagnostics(
         diagnostics,
         not self._async_diags and self._open_loclist_on_ycm_diags )
 
 
   def UpdateMatches( self ):
-    self._diag_interface.UpdateMatches()
+    self.diag_interface.UpdateMatches()
 
 
   def PopulateLocationList( self, open_on_edit = False ):
-    return self._diag_interface.PopulateLocationList( open_on_edit )
+    return self.diag_interface.PopulateLocationList( open_on_edit )
 
 
   def GetResponse( self ):
@@ -116,29 +231,45 @@ class Buffer:
 
 
   def OnCursorMoved( self ):
-    self._diag_interface.OnCursorMoved()
+    if self._diag_interface is not None:
+      self._diag_interface.OnCursorMoved()
 
 
   def GetErrorCount( self ):
+    if self._diag_interface is None:
+      return 0
     return self._diag_interface.GetErrorCount()
 
 
   def GetWarningCount( self ):
+    if self._diag_interface is None:
+      return 0
     return self._diag_interface.GetWarningCount()
 
 
   def RefreshDiagnosticsUI( self ):
-    return self._diag_interface.RefreshDiagnosticsUI()
+    return self.diag_interface.RefreshDiagnosticsUI()
 
 
   def ClearDiagnosticsUI( self ):
-    return self._diag_interface.ClearDiagnosticsUI()
+    return self.diag_interface.ClearDiagnosticsUI()
 
 
   def DiagnosticsForLine( self, line_number ):
+    if self._diag_interface is None:
+      return []
     return self._diag_interface.DiagnosticsForLine( line_number )
 
 
+  def MemoryUsage( self ):
+    """Returns an approximation in bytes of the memory used by this buffer,
+    dominated by its diagnostics."""
+    size = _DeepSizeOf( self.__dict__ )
+    if self._diag_interface is not None:
+      size += _DeepSizeOf( self._diag_interface.__dict__ )
+    return size
+
+
   def UpdateFromFileTypes( self, filetypes ):
     self._filetypes = filetypes
     # We will set this to true if we ever receive any diagnostics asyncronously.
@@ -149,17 +280,59 @@ class Buffer:
     return vimsupport.GetBufferChangedTick( self._number )
 
 
-class BufferDict( dict ):
+def _DeepSizeOf( value ):
+  size = sys.getsizeof( value )
+  if isinstance( value, dict ):
+    size += sum( _DeepSizeOf( key ) + _DeepSizeOf( item )
+                 for key, item in value.items() )
+  elif isinstance( value, ( list, tuple, set ) ):
+    size += sum( _DeepSizeOf( item ) for item in value )
+  return size
+
+
+# Buffers are kept in least recently used order.
+class BufferDict( OrderedDict ):
 
   def __init__( self, user_options ):
+    super().__init__()
     self._user_options = user_options
 
 
+  def __getitem__( self, key ):
+    value = super().__getitem__( key )
+    self.move_to_end( key )
+    return value
+
+
+  def UpdateOptions( self, user_options ):
+    self._user_options = user_options
+    for buffer in self.values():
+      buffer.UpdateOptions( user_options )
+
+
   def __missing__( self, key ):
     # Python does not allow to return assignment operation result directly
     new_value = self[ key ] = Buffer(
       key,
       self._user_options,
       vimsupport.GetBufferFiletypes( key ) )
+    self._EvictHiddenBuffers()
 
     return new_value
+
+
+  def _EvictHiddenBuffers( self ):
+    if len( self ) <= MAX_HIDDEN_BUFFERS + EVICTION_BATCH_SIZE:
+      return
+
+    visible_buffers = vimsupport.VisibleBufferNumbers()
+    hidden_buffers = [ bufnr for bufnr in self
+                       if bufnr not in visible_buffers ]
+    evicted_buffers = hidden_buffers[
+      : max( len( hidden_buffers ) - MAX_HIDDEN_BUFFERS, 0 ) ]
+    # Don't leave signs and highlighting that we can't clear later.
+    loaded_buffers = vimsupport.LoadedBufferNumbers( evicted_buffers )
+    for bufnr in evicted_buffers:
+      buffer = self.pop( bufnr )
+      if bufnr in loaded_buffers:
+        buffer.ClearDiagnosticsUI()
@@ -0,0 +1,117 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+import os
+from ycm import vimsupport
+
+HEADER_EXTENSIONS = [ '.h', '.hh', '.hpp', '.hxx', '.h++', '.inl', '.ipp' ]
+SOURCE_EXTENSIONS = [ '.c', '.cc', '.cpp', '.cxx', '.c++', '.m', '.mm' ]
+
+# Stop prefetching once the server spent that many seconds parsing buffers in
+# the same idle period.
+PREFETCH_BUDGET_SECONDS = 10
+
+
+def AlternateFiles( filepath ):
+  """Returns the paths of the headers of source file |filepath| or the paths of
+  the sources of header |filepath|, whether they exist or not."""
+  root, extension = os.path.splitext( filepath )
+  extension = extension.lower()
+  if extension in SOURCE_EXTENSIONS:
+    alternate_extensions = HEADER_EXTENSIONS
+  elif extension in HEADER_EXTENSIONS:
+    alternate_extensions = SOURCE_EXTENSIONS
+  else:
+    return []
+  return [ root + alternate_extension
+           for alternate_extension in alternate_extensions ]
+
+
+class BufferPrefetcher:
+  """Parses buffers the user is likely to visit next while Vim is idle so that
+  the server has them ready when they are entered. Buffers are parsed one at a
+  time and only if they changed since they were last prefetched. The parse is
+  recorded on the Buffer object returned by |get_buffer| so that it isn't
+  parsed again when entered."""
+
+  def __init__( self, max_buffers, has_semantic_completer, get_buffer ):
+    self._max_buffers = max_buffers
+    self._has_semantic_completer = has_semantic_completer
+    self._get_buffer = get_buffer
+    self._candidates = []
+    self._extra_data = None
+    self._buffer = None
+    self._spent_seconds = 0
+
+
+  def Start( self, buffer_numbers, extra_data ):
+    """Starts prefetching the buffers that are paired with the current one then
+    the hidden buffers in |buffer_numbers|, given from least to most recently
+    used."""
+    self.Stop()
+    if self._max_buffers <= 0:
+      return
+
+    current_buffer_number = vimsupport.GetCurrentBufferNumber()
+    candidates = [
+      vimsupport.GetBufferNumberForFilename( filepath )
+      for filepath in AlternateFiles(
+        vimsupport.GetCurrentBufferFilepath() ) ]
+    candidates.extend( bufnr for bufnr in reversed( buffer_numbers )
+                       if not vimsupport.BufferIsVisible( bufnr ) )
+
+    for bufnr in candidates:
+      if len( self._candidates ) == self._max_buffers:
+        break
+      if ( bufnr > 0 and
+           bufnr != current_buffer_number and
+           bufnr not in self._candidates and
+           vimsupport.BufferIsLoaded( bufnr ) and
+           self._has_semantic_completer(
+             vimsupport.GetBufferFiletypes( bufnr ) ) ):
+        self._candidates.append( bufnr )
+    self._extra_data = extra_data
+
+
+  def Stop( self ):
+    self._candidates = []
+    self._buffer = None
+    self._spent_seconds = 0
+
+
+  def Poll( self ):
+    """Sends the next parse request when the previous one is done. Returns
+    whether it should be called again."""
+    if self._buffer is not None:
+      if not self._buffer.FileParseRequestReady():
+        return True
+      self._spent_seconds += self._buffer.ParseRequestDuration() or 0
+      self._buffer = None
+
+    while self._candidates and self._spent_seconds < PREFETCH_BUDGET_SECONDS:
+      bufnr = self._candidates.pop( 0 )
+      if not vimsupport.BufferIsLoaded( bufnr ):
+        continue
+      buffer = self._get_buffer( bufnr )
+      if buffer.IsPrefetched() or buffer.ParseRequestPending():
+        continue
+      buffer.SendParseRequest( self._extra_data, prefetch = True )
+      self._buffer = buffer
+      return True
+
+    self.Stop()
+    return False
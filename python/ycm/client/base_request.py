@@ -15,17 +15,25 @@
 # You should have received a copy of the GNU General Public License
 # along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
 
+import hashlib
+import hmac
 import logging
 import json
+import math
+import socket
+import threading
+import time
 import vim
+import zlib
 from base64 import b64decode, b64encode
-from hmac import compare_digest
+from collections import defaultdict
+from copy import deepcopy
 from urllib.parse import urljoin, urlparse, urlencode
 from urllib.request import Request, urlopen
 from urllib.error import URLError, HTTPError
-from ycm import vimsupport
+from ycm import metrics, vimsupport
 from ycmd.utils import ToBytes, GetCurrentDirectory, ToUnicode
-from ycmd.hmac_utils import CreateRequestHmac, CreateHmac
+from ycmd.hmac_utils import CreateHmac, CreateRequestHmac
 from ycmd.responses import ServerError, UnknownExtraConf
 
 HTTP_SERVER_ERROR = 500
@@ -35,9 +43,208 @@ _CONNECT_TIMEOUT_SEC = 0.01
 # Setting this to None seems to screw up the Requests/urllib3 libs.
 _READ_TIMEOUT_SEC = 30
 _HMAC_HEADER = 'x-ycm-hmac'
+# Responses are read and hashed by chunks of that many bytes.
+_RESPONSE_CHUNK_SIZE = 65536
+# Bodies are compressed with deflate, i.e. the zlib format of RFC 1950. Fast
+# compression is enough since the payloads are mostly repetitive source code.
+_COMPRESSION_ENCODING = 'deflate'
+_COMPRESSION_LEVEL = 1
+# The timeout of the requests to some handlers is derived from their latency:
+# it's that quantile multiplied by that factor, within these bounds. Responses
+# to interactive requests are useless once the user moved on, and background
+# requests are sent again as soon as the buffer changes, so that a stuck one is
+# reclaimed quickly. Until enough latencies are known, the fixed timeout is used
+# since the first requests to a server that is still loading the project, e.g.
+# a cold clangd, may be slow. Other handlers, which include parsing files and
+# running commands, may legitimately take long and always use the fixed
+# timeout.
+TIMEOUT_QUANTILE = 0.999
+TIMEOUT_FACTOR = 4
+MIN_TIMEOUT_SEC = 2
+MIN_LATENCY_SAMPLES = 100
+INTERACTIVE_TIMEOUT_CEILING_SEC = 10
+BACKGROUND_TIMEOUT_CEILING_SEC = 20
+_TIMEOUT_CEILINGS_SEC = {
+  'completions': INTERACTIVE_TIMEOUT_CEILING_SEC,
+  'resolve_completion': INTERACTIVE_TIMEOUT_CEILING_SEC,
+  'signature_help': INTERACTIVE_TIMEOUT_CEILING_SEC,
+  'semantic_tokens': BACKGROUND_TIMEOUT_CEILING_SEC,
+  'inlay_hints': BACKGROUND_TIMEOUT_CEILING_SEC,
+}
 _logger = logging.getLogger( __name__ )
 
 
+class RoundTripStatistics:
+  """Keeps track of when the server last answered a request and of the
+  smoothed round-trip time of the requests, weighted as in RFC 6298."""
+
+  SMOOTHING_FACTOR = 0.125
+
+  def __init__( self ):
+    self.last_response_time = None
+    self.smoothed_seconds = None
+    self.count = 0
+
+
+  def Record( self, start_time, end_time ):
+    round_trip_seconds = end_time - start_time
+    self.last_response_time = end_time
+    self.count += 1
+    if self.smoothed_seconds is None:
+      self.smoothed_seconds = round_trip_seconds
+    else:
+      self.smoothed_seconds += self.SMOOTHING_FACTOR * (
+        round_trip_seconds - self.smoothed_seconds )
+
+
+_round_trip_statistics = RoundTripStatistics()
+
+
+def GetRoundTripStatistics():
+  return _round_trip_statistics
+
+
+def PingServer( server_location, hmac_secret ):
+  """Sends a request to the server at |server_location|, other than the one
+  used by the requests (e.g. the standby server), so that it doesn't shut
+  itself down for being idle. Returns whether the server answered."""
+  path = '/healthy'
+  headers = dict( _HEADERS )
+  headers[ _HMAC_HEADER ] = b64encode(
+    CreateRequestHmac( b'GET', ToBytes( path ), b'', hmac_secret ) )
+  try:
+    with urlopen( Request( urljoin( server_location, path ),
+                           headers = headers ),
+                  timeout = _READ_TIMEOUT_SEC ):
+      return True
+  except OSError as error:
+    _logger.info( 'Ping of server at %s failed: %s', server_location, error )
+    return False
+
+
+class LatencyHistogram:
+  """Counts the latencies of the requests to a handler in buckets growing
+  geometrically from 1 ms to about a minute, so that quantiles are known within
+  a factor of BUCKET_GROWTH whatever the latencies. Also counts the requests
+  that timed out."""
+
+  MIN_SECONDS = 0.001
+  BUCKET_GROWTH = 2 ** 0.25
+  NUM_BUCKETS = 64
+
+  def __init__( self ):
+    self._buckets = [ 0 ] * self.NUM_BUCKETS
+    self.count = 0
+    self.timeouts = 0
+
+
+  def Record( self, seconds, timed_out = False ):
+    # Timed out requests are counted with the time waited for them so that
+    # the timeout grows when the server becomes slower.
+    if seconds <= self.MIN_SECONDS:
+      index = 0
+    else:
+      index = min( self.NUM_BUCKETS - 1,
+                   math.ceil( math.log( seconds / self.MIN_SECONDS,
+                                        self.BUCKET_GROWTH ) ) )
+    self._buckets[ index ] += 1
+    self.count += 1
+    if timed_out:
+      self.timeouts += 1
+
+
+  def Quantile( self, quantile ):
+    """Returns the upper bound of the bucket holding the |quantile| of the
+    latencies or None if there is none."""
+    if not self.count:
+      return None
+    rank = quantile * self.count
+    cumulative_count = 0
+    for index, count in enumerate( self._buckets ):
+      cumulative_count += count
+      if cumulative_count >= rank:
+        break
+    return self.MIN_SECONDS * self.BUCKET_GROWTH ** index
+
+
+# The histograms and the round-trip statistics are updated from the request
+# threads, hence the lock.
+_latency_histograms_lock = threading.Lock()
+_latency_histograms = defaultdict( LatencyHistogram )
+
+
+def GetLatencyHistograms():
+  return _latency_histograms
+
+
+def LatencyHistogramsSnapshot():
+  """Returns copies of the latency histograms as a list of pairs of handler and
+  histogram sorted by handler."""
+  with _latency_histograms_lock:
+    return sorted( ( handler, deepcopy( histogram ) )
+                   for handler, histogram in _latency_histograms.items() )
+
+
+def ResetLatencyStatistics():
+  """Forgets the latencies and round-trip times recorded so far. Must be called
+  whenever a different server is used since they depend on it."""
+  global _round_trip_statistics
+  with _latency_histograms_lock:
+    _latency_histograms.clear()
+    _round_trip_statistics = RoundTripStatistics()
+
+
+def AdaptiveTimeout( handler ):
+  """Returns the timeout in seconds for a request to |handler|."""
+  ceiling = _TIMEOUT_CEILINGS_SEC.get( handler )
+  if ceiling is None:
+    return _READ_TIMEOUT_SEC
+  histogram = _latency_histograms.get( handler )
+  if histogram is None or histogram.count < MIN_LATENCY_SAMPLES:
+    return _READ_TIMEOUT_SEC
+  timeout = histogram.Quantile( TIMEOUT_QUANTILE ) * TIMEOUT_FACTOR
+  return min( ceiling, max( MIN_TIMEOUT_SEC, timeout ) )
+
+
+def _SendRequest( request, handler, timeout ):
+  """Sends |request| to |handler| and records its latency, including when the
+  server returns an error or doesn't answer in time."""
+  start_time = time.monotonic()
+  try:
+    response = urlopen( request,
+                        timeout = max( _CONNECT_TIMEOUT_SEC, timeout ) )
+  except HTTPError:
+    # The server received the request but returned an error.
+    _RecordResponseTime( handler, start_time, time.monotonic() )
+    raise
+  except OSError as error:
+    if _IsTimeout( error ):
+      _logger.warning( 'Request to %s timed out after %.1f seconds',
+                       handler, timeout )
+      _RecordLatency( handler, time.monotonic() - start_time,
+                      timed_out = True )
+    raise
+  _RecordResponseTime( handler, start_time, time.monotonic() )
+  return response
+
+
+def _RecordResponseTime( handler, start_time, end_time ):
+  with _latency_histograms_lock:
+    _round_trip_statistics.Record( start_time, end_time )
+    _latency_histograms[ handler ].Record( end_time - start_time )
+
+
+def _RecordLatency( handler, seconds, timed_out = False ):
+  with _latency_histograms_lock:
+    _latency_histograms[ handler ].Record( seconds, timed_out )
+
+
+def _IsTimeout( error ):
+  if isinstance( error, URLError ):
+    error = error.reason
+  return isinstance( error, socket.timeout )
+
+
 class BaseRequest:
 
   def __init__( self ):
@@ -87,6 +294,11 @@ class BaseRequest:
       # don't want to spam the user with it.
       _logger.error( e )
 
+    except socket.timeout as e:
+      # Neither do we display timeouts: the requests with an adaptive timeout
+      # are sent again as soon as the user moves on or the buffer changes.
+      _logger.warning( 'Request timed out: %s', e )
+
     except Exception as e:
       _logger.exception( 'Error while handling server response' )
       if display_message:
@@ -97,12 +309,13 @@ class BaseRequest:
 
   # This method blocks
   # |timeout| is num seconds to tolerate no response from server before giving
-  # up; see Requests docs for details (we just pass the param along).
+  # up; see Requests docs for details (we just pass the param along). When it's
+  # None, it is derived from the latencies of the handler; see AdaptiveTimeout.
   # See the HandleFuture method for the |display_message| and |truncate_message|
   # parameters.
   def GetDataFromHandler( self,
                           handler,
-                          timeout = _READ_TIMEOUT_SEC,
+                          timeout = None,
                           display_message = True,
                           truncate_message = False,
                           payload = None ):
@@ -114,7 +327,7 @@ class BaseRequest:
 
   def GetDataFromHandlerAsync( self,
                                handler,
-                               timeout = _READ_TIMEOUT_SEC,
+                               timeout = None,
                                payload = None ):
     return BaseRequest._TalkToHandlerAsync(
         '', handler, 'GET', timeout, payload )
@@ -122,13 +335,14 @@ class BaseRequest:
 
   # This is the blocking version of the method. See below for async.
   # |timeout| is num seconds to tolerate no response from server before giving
-  # up; see Requests docs for details (we just pass the param along).
+  # up; see Requests docs for details (we just pass the param along). When it's
+  # None, it is derived from the latencies of the handler; see AdaptiveTimeout.
   # See the HandleFuture method for the |display_message| and |truncate_message|
   # parameters.
   def PostDataToHandler( self,
                          data,
                          handler,
-                         timeout = _READ_TIMEOUT_SEC,
+                         timeout = None,
                          display_message = True,
                          truncate_message = False ):
     return self.HandleFuture(
@@ -139,30 +353,33 @@ class BaseRequest:
 
   # This returns a future! Use HandleFuture to get the value.
   # |timeout| is num seconds to tolerate no response from server before giving
-  # up; see Requests docs for details (we just pass the param along).
+  # up; see Requests docs for details (we just pass the param along). When it's
+  # None, it is derived from the latencies of the handler; see AdaptiveTimeout.
   @staticmethod
-  def PostDataToHandlerAsync( data, handler, timeout = _READ_TIMEOUT_SEC ):
+  def PostDataToHandlerAsync( data, handler, timeout = None ):
     return BaseRequest._TalkToHandlerAsync( data, handler, 'POST', timeout )
 
 
   # This returns a future! Use HandleFuture to get the value.
   # |method| is either 'POST' or 'GET'.
   # |timeout| is num seconds to tolerate no response from server before giving
-  # up; see Requests docs for details (we just pass the param along).
+  # up; see Requests docs for details (we just pass the param along). When it's
+  # None, it is derived from the latencies of the handler; see AdaptiveTimeout.
   @staticmethod
   def _TalkToHandlerAsync( data,
                            handler,
                            method,
-                           timeout = _READ_TIMEOUT_SEC,
+                           timeout = None,
                            payload = None ):
     def _MakeRequest( data, handler, method, timeout, payload ):
       request_uri = _BuildUri( handler )
 
       if method == 'POST':
-        sent_data = _ToUtf8Json( data )
-        headers = BaseRequest._ExtraHeaders( method,
-                                             request_uri,
-                                             sent_data )
+        sent_data, content_encoding, body_hmac = _EncodeBody( data )
+        headers = BaseRequest._ExtraHeaders( method, request_uri, body_hmac )
+        if content_encoding:
+          headers[ 'content-encoding' ] = content_encoding
+        metrics.Increment( 'bytes', 'sent', len( sent_data ) )
         _logger.debug( 'POST %s\n%s\n%s', request_uri, headers, sent_data )
       else:
         headers = BaseRequest._ExtraHeaders( method, request_uri )
@@ -170,34 +387,43 @@ class BaseRequest:
           request_uri += ToBytes( f'?{urlencode( payload )}' )
 
         _logger.debug( 'GET %s (%s)\n%s', request_uri, payload, headers )
-      return urlopen(
+      return _SendRequest(
         Request(
           ToUnicode( request_uri ),
           data = sent_data if data else None,
           headers = headers,
           method = method ),
-        timeout = max( _CONNECT_TIMEOUT_SEC, timeout ) )
+        handler,
+        timeout )
 
 
-    return BaseRequest.Executor().submit(
+    if timeout is None:
+      timeout = AdaptiveTimeout( handler )
+    metrics.Increment( 'requests', handler )
+    metrics.AddToGauge( 'requests_in_flight', 1 )
+    future = BaseRequest.Executor().submit(
       _MakeRequest,
       data,
       handler,
       method,
       timeout,
       payload )
+    future.add_done_callback(
+      lambda _: metrics.AddToGauge( 'requests_in_flight', -1 ) )
+    return future
 
 
   @staticmethod
-  def _ExtraHeaders( method, request_uri, request_body = None ):
-    if not request_body:
-      request_body = bytes( b'' )
+  def _ExtraHeaders( method, request_uri, body_hmac = None ):
+    if body_hmac is None:
+      body_hmac = CreateHmac( bytes( b'' ), BaseRequest.hmac_secret )
     headers = dict( _HEADERS )
+    if BaseRequest.compression_threshold > 0:
+      headers[ 'accept-encoding' ] = _COMPRESSION_ENCODING
     headers[ _HMAC_HEADER ] = b64encode(
-        CreateRequestHmac( ToBytes( method ),
-                           ToBytes( urlparse( request_uri ).path ),
-                           request_body,
-                           BaseRequest.hmac_secret ) )
+        _CreateRequestHmac( ToBytes( method ),
+                            ToBytes( urlparse( request_uri ).path ),
+                            body_hmac ) )
     return headers
 
 
@@ -215,11 +441,18 @@ class BaseRequest:
 
   server_location = ''
   hmac_secret = ''
+  # Bodies of at least that many bytes are compressed if the server accepts
+  # it. Compression is disabled when it's 0.
+  compression_threshold = 0
+  # Content encodings the server accepts for request bodies, as advertised
+  # in the Accept-Encoding header of its responses (RFC 7694).
+  accepted_encodings = frozenset()
 
 
-def BuildRequestData( buffer_number = None ):
+def BuildRequestData( buffer_number = None, full_contents = False ):
   """Build request for the current buffer or the buffer with number
-  |buffer_number| if specified."""
+  |buffer_number| if specified. Set |full_contents| to send the whole contents
+  of the buffers in large file mode."""
   working_dir = GetCurrentDirectory()
   current_buffer = vim.current.buffer
 
@@ -232,8 +465,8 @@ def BuildRequestData( buffer_number = None ):
       'line_num': 1,
       'column_num': 1,
       'working_dir': working_dir,
-      'file_data': vimsupport.GetUnsavedAndSpecifiedBufferData( buffer_object,
-                                                                filepath )
+      'file_data': vimsupport.GetUnsavedAndSpecifiedBufferData(
+        buffer_object, filepath, full_contents )
     }
 
   current_filepath = vimsupport.GetBufferFilepath( current_buffer )
@@ -244,17 +477,20 @@ def BuildRequestData( buffer_number = None ):
     'line_num': line + 1,
     'column_num': column + 1,
     'working_dir': working_dir,
-    'file_data': vimsupport.GetUnsavedAndSpecifiedBufferData( current_buffer,
-                                                              current_filepath )
+    'file_data': vimsupport.GetUnsavedAndSpecifiedBufferData(
+      current_buffer, current_filepath, full_contents )
   }
 
 
 def _JsonFromFuture( future ):
   try:
     response = future.result()
-    response_text = response.read()
-    _ValidateResponseObject( response, response_text )
+    response_text, response_hmac = _ReadResponse( response )
+    metrics.Increment( 'bytes', 'received', len( response_text ) )
+    _ValidateResponseObject( response, response_text, response_hmac )
     response.close()
+    _RecordAcceptedEncodings( response )
+    response_text = _DecodeResponse( response, response_text )
 
     if response_text:
       return json.loads( response_text )
@@ -290,16 +526,95 @@ def DisplayServerException( exception, truncate_message = False ):
   vimsupport.PostVimMessage( serialized_exception, truncate = truncate_message )
 
 
+def _NewHmac():
+  return hmac.new( ToBytes( BaseRequest.hmac_secret ),
+                   digestmod = hashlib.sha256 )
+
+
+def _CreateRequestHmac( method, path, body_hmac ):
+  # Same as ycmd's CreateRequestHmac but taking the HMAC of the body, which is
+  # computed while the body is serialized.
+  return CreateHmac( bytes().join( (
+                       CreateHmac( method, BaseRequest.hmac_secret ),
+                       CreateHmac( path, BaseRequest.hmac_secret ),
+                       body_hmac ) ),
+                     BaseRequest.hmac_secret )
+
+
 def _ToUtf8Json( data ):
   return ToBytes( json.dumps( data ) if data else None )
 
 
-def _ValidateResponseObject( response, response_text ):
+def _ShouldCompress( body ):
+  return ( BaseRequest.compression_threshold > 0 and
+           _COMPRESSION_ENCODING in BaseRequest.accepted_encodings and
+           len( body ) >= BaseRequest.compression_threshold )
+
+
+def _EncodeBody( data ):
+  """Serializes |data| to JSON, compresses it if worth it, and returns the body
+  as sent along with its content encoding, None if it's not compressed, and its
+  HMAC, which is what the server checks before decompressing. The body is a
+  single bytes object so that http.client sends it with the headers."""
+  body = _ToUtf8Json( data )
+  content_encoding = None
+  if _ShouldCompress( body ):
+    body = zlib.compress( body, _COMPRESSION_LEVEL )
+    content_encoding = _COMPRESSION_ENCODING
+  return body, content_encoding, CreateHmac( body, BaseRequest.hmac_secret )
+
+
+def _RecordAcceptedEncodings( response ):
+  accept_encoding = response.headers.get( 'accept-encoding' )
+  if accept_encoding is None:
+    return
+  BaseRequest.accepted_encodings = frozenset(
+    encoding.split( ';' )[ 0 ].strip().lower()
+    for encoding in accept_encoding.split( ',' ) )
+
+
+def _DecodeResponse( response, response_text ):
+  # The HMAC is computed on the body as sent so this must be done after
+  # validating it.
+  content_encoding = response.headers.get( 'content-encoding' )
+  if content_encoding and response_text:
+    if content_encoding.lower() != _COMPRESSION_ENCODING:
+      raise RuntimeError(
+        f'Received response with unsupported encoding { content_encoding }!' )
+    return zlib.decompress( response_text )
+  return response_text
+
+
+def _ReadResponse( response ):
+  """Reads the body of |response| by chunks and returns it along with its
+  HMAC, which is updated as each chunk arrives. When the length of the body is
+  known, the chunks are read in place into a single buffer."""
+  response_hmac = _NewHmac()
+  length = getattr( response, 'length', None )
+  if length is None:
+    response_text = response.read()
+    response_hmac.update( response_text )
+    return response_text, response_hmac.digest()
+
+  response_text = bytearray( length )
+  view = memoryview( response_text )
+  offset = 0
+  while offset < length:
+    read = response.readinto( view[ offset : offset + _RESPONSE_CHUNK_SIZE ] )
+    if not read:
+      break
+    response_hmac.update( view[ offset : offset + read ] )
+    offset += read
+  view.release()
+  del response_text[ offset : ]
+  return response_text, response_hmac.digest()
+
+
+def _ValidateResponseObject( response, response_text, response_hmac ):
   if not response_text:
     return
-  our_hmac = CreateHmac( response_text, BaseRequest.hmac_secret )
   their_hmac = ToBytes( b64decode( response.headers[ _HMAC_HEADER ] ) )
-  if not compare_digest( our_hmac, their_hmac ):
+  if not hmac.compare_digest( response_hmac, their_hmac ):
     raise RuntimeError( 'Received invalid HMAC for response!' )
 
 
@@ -41,10 +41,12 @@ class CommandRequest( BaseRequest ):
 
 
   def Start( self ):
+    # Commands like FixIt, Format or RefactorRename return edits computed on
+    # the contents we send so large files are sent whole.
     if self._bufnr is not None:
-      self._request_data = BuildRequestData( self._bufnr )
+      self._request_data = BuildRequestData( self._bufnr, full_contents = True )
     else:
-      self._request_data = BuildRequestData()
+      self._request_data = BuildRequestData( full_contents = True )
 
     if self._extra_data:
       self._request_data.update( self._extra_data )
@@ -23,6 +23,7 @@ class CompleterAvailableRequest( BaseRequest ):
     super( CompleterAvailableRequest, self ).__init__()
     self.filetypes = filetypes
     self._response = None
+    self._response_future = None
 
 
   def Start( self ):
@@ -32,12 +33,26 @@ class CompleterAvailableRequest( BaseRequest ):
                                              'semantic_completion_available' )
 
 
+  def StartAsync( self ):
+    request_data = BuildRequestData()
+    request_data.update( { 'filetypes': self.filetypes } )
+    self._response_future = self.PostDataToHandlerAsync(
+      request_data,
+      'semantic_completion_available' )
+
+
+  def Done( self ):
+    return bool( self._response_future ) and self._response_future.done()
+
+
   def Response( self ):
+    if self._response is None and self._response_future:
+      self._response = self.HandleFuture( self._response_future,
+                                          truncate_message = True )
     return self._response
 
 
-def SendCompleterAvailableRequest( filetypes ):
+def SendCompleterAvailableRequestAsync( filetypes ):
   request = CompleterAvailableRequest( filetypes )
-  # This is a blocking call.
-  request.Start()
-  return request.Response()
+  request.StartAsync()
+  return request
@@ -15,17 +15,27 @@
 # You should have received a copy of the GNU General Public License
 # along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
 
+import time
 from ycm.client.base_request import BaseRequest, BuildRequestData
 
 
 class EventNotification( BaseRequest ):
-  def __init__( self, event_name, buffer_number = None, extra_data = None ):
+  def __init__( self,
+                event_name,
+                buffer_number = None,
+                extra_data = None,
+                on_success = None ):
+    """|on_success| is called without arguments, from the thread that sent the
+    request, once the server answered it without error."""
     super( EventNotification, self ).__init__()
     self._event_name = event_name
     self._buffer_number = buffer_number
     self._extra_data = extra_data
+    self._on_success = on_success
     self._response_future = None
     self._cached_response = None
+    self._start_time = None
+    self._end_time = None
 
 
   def Start( self ):
@@ -34,8 +44,31 @@ class EventNotification( BaseRequest ):
       request_data.update( self._extra_data )
     request_data[ 'event_name' ] = self._event_name
 
+    self._start_time = time.perf_counter()
     self._response_future = self.PostDataToHandlerAsync( request_data,
                                                          'event_notification' )
+    self._response_future.add_done_callback( self._RecordEndTime )
+    if self._on_success:
+      self._response_future.add_done_callback( self._CallOnSuccess )
+
+
+  def _RecordEndTime( self, future ):
+    # Called from the thread that sent the request.
+    self._end_time = time.perf_counter()
+
+
+  def _CallOnSuccess( self, future ):
+    # Called from the thread that sent the request.
+    if not future.cancelled() and future.exception() is None:
+      self._on_success()
+
+
+  def Duration( self ):
+    """Returns the number of seconds the server took to answer the request or
+    None if it hasn't answered yet."""
+    if self._end_time is None:
+      return None
+    return self._end_time - self._start_time
 
 
   def Done( self ):
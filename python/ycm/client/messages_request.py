@@ -29,23 +29,28 @@ TIMEOUT_SECONDS = 60
 class MessagesPoll( BaseRequest ):
   def __init__( self, buff ):
     super( MessagesPoll, self ).__init__()
-    self._request_data = BuildRequestData( buff.number )
+    self._buffer_number = buff.number
     self._response_future = None
 
 
   def _SendRequest( self ):
+    # The server converts the positions of the diagnostics using the contents of
+    # the buffers so they must be up to date.
     self._response_future = self.PostDataToHandlerAsync(
-      self._request_data,
+      BuildRequestData( self._buffer_number ),
       'receive_messages',
       timeout = TIMEOUT_SECONDS )
     return
 
 
-  def Poll( self, diagnostics_handler ):
+  def Poll( self, diagnostics_handler, buff = None ):
     """This should be called regularly to check for new messages in this buffer.
     Returns True if Poll should be called again in a while. Returns False when
     the completer or server indicated that further polling should not be done
-    for the requested file."""
+    for the requested file. The next request is sent for the buffer |buff| if
+    given, since the buffer the poll was created for may no longer exist."""
+    if buff is not None:
+      self._buffer_number = buff.number
 
     if self._response_future is None:
       # First poll
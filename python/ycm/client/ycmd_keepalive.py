@@ -17,25 +17,71 @@
 
 import time
 from threading import Thread
-from ycm.client.base_request import BaseRequest
+from ycm.client.base_request import ( BaseRequest, GetRoundTripStatistics,
+                                      PingServer )
 
 
 # This class can be used to keep the ycmd server alive for the duration of the
 # life of the client. By default, ycmd shuts down if it doesn't see a request in
-# a while.
+# a while. A ping is only sent when no other request reached the server in the
+# last |ping_interval_seconds|; the ping is timed like any other request. The
+# standby server, if any, receives no other request so it is pinged every
+# interval.
 class YcmdKeepalive:
   def __init__( self, ping_interval_seconds = 60 * 10 ):
     self._keepalive_thread = Thread( target = self._ThreadMain )
     self._keepalive_thread.daemon = True
     self._ping_interval_seconds = ping_interval_seconds
+    self._last_ping_time = time.monotonic()
+    self._last_standby_ping_time = time.monotonic()
+    self._standby_server = None
 
 
   def Start( self ):
+    self._last_ping_time = time.monotonic()
+    self._last_standby_ping_time = time.monotonic()
     self._keepalive_thread.start()
 
 
+  def SetStandbyServer( self, server_location, hmac_secret ):
+    """Sets the location and HMAC secret of the standby server to ping. Pass
+    None as |server_location| when there is no standby server anymore."""
+    if server_location is None:
+      self._standby_server = None
+    else:
+      self._standby_server = ( server_location, hmac_secret )
+
+
+  def _SecondsUntilNextPing( self ):
+    last_activity_time = self._last_ping_time
+    last_response_time = GetRoundTripStatistics().last_response_time
+    if last_response_time is not None:
+      last_activity_time = max( last_activity_time, last_response_time )
+    return last_activity_time + self._ping_interval_seconds - time.monotonic()
+
+
+  def _SecondsUntilNextStandbyPing( self ):
+    return ( self._last_standby_ping_time + self._ping_interval_seconds -
+             time.monotonic() )
+
+
   def _ThreadMain( self ):
     while True:
-      time.sleep( self._ping_interval_seconds )
+      time.sleep( max( 0, min( self._SecondsUntilNextPing(),
+                               self._SecondsUntilNextStandbyPing() ) ) )
+
+      if self._SecondsUntilNextPing() <= 0:
+        # Wait for a whole interval before the next ping even if this one
+        # fails.
+        self._last_ping_time = time.monotonic()
+        BaseRequest().GetDataFromHandler( 'healthy', display_message = False )
+
+      if self._SecondsUntilNextStandbyPing() <= 0:
+        self._last_standby_ping_time = time.monotonic()
+        self._PingStandbyServer()
+
 
-      BaseRequest().GetDataFromHandler( 'healthy', display_message = False )
+  def _PingStandbyServer( self ):
+    standby_server = self._standby_server
+    if standby_server:
+      PingServer( *standby_server )
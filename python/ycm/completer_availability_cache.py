@@ -0,0 +1,96 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+import hashlib
+import json
+import os
+from ycm import disk_cache, metrics, paths
+
+# Whether the server has a semantic completer for a filetype only depends on
+# how ycmd was built and on the options it was started with. The answers are
+# cached on disk so that a new session knows them before asking the server.
+# The build is identified by the files written by ycmd's build script.
+CACHE_VERSION = 1
+
+
+def _CacheFile():
+  return os.path.join( disk_cache.CacheDirectory( 'completer_availability' ),
+                       'completers.json' )
+
+
+def _BuildStamp():
+  stamp = []
+  for filename in [ 'PYTHON_USED_DURING_BUILDING', 'third_party' ]:
+    try:
+      stamp.append(
+        os.stat( os.path.join( paths.DIR_OF_YCMD, filename ) ).st_mtime_ns )
+    except OSError:
+      return None
+  return stamp
+
+
+def _CacheKey( server_options ):
+  build_stamp = _BuildStamp()
+  # We can't tell when ycmd is rebuilt.
+  if build_stamp is None:
+    return None
+  options = json.dumps( server_options, sort_keys = True, default = str )
+  return {
+    'version': CACHE_VERSION,
+    'ycmd': os.path.realpath( paths.DIR_OF_YCMD ),
+    'build': build_stamp,
+    'options': hashlib.sha256( options.encode( 'utf-8' ) ).hexdigest()
+  }
+
+
+class CompleterAvailabilityCache:
+  def __init__( self, server_options ):
+    self._server_options = server_options
+    self._key = None
+    self._available_completers = None
+
+
+  def _Load( self ):
+    if self._available_completers is not None:
+      return
+    self._key = _CacheKey( self._server_options )
+    self._available_completers = {}
+    if self._key is not None:
+      self._available_completers = disk_cache.Load( _CacheFile(),
+                                                    self._key ) or {}
+
+
+  def Get( self, filetype ):
+    """Returns whether the server has a semantic completer for |filetype| or
+    None if it isn't known."""
+    self._Load()
+    available = self._available_completers.get( filetype )
+    metrics.RecordCacheLookup( 'completer_availability', available is not None )
+    return available
+
+
+  def Set( self, filetype, available ):
+    self._Load()
+    if self._available_completers.get( filetype ) == available:
+      return
+    self._available_completers[ filetype ] = available
+    if self._key is None:
+      return
+    # Keep the filetypes checked by other Vim instances meanwhile.
+    available_completers = disk_cache.Load( _CacheFile(), self._key ) or {}
+    available_completers.update( self._available_completers )
+    disk_cache.Save( _CacheFile(), self._key, available_completers )
@@ -35,13 +35,18 @@ class DiagnosticInterface:
     self._diag_message_needs_clearing = False
 
 
+  def UpdateOptions( self, user_options ):
+    self._user_options = user_options
+    self._diag_filter = DiagnosticFilter.CreateFromOptions( user_options )
+
+
   def ShouldUpdateDiagnosticsUINow( self ):
-    return ( self._user_options[ 'update_diagnostics_in_insert_mode' ] or
+    return ( self._user_options.update_diagnostics_in_insert_mode or
              'i' not in vim.eval( 'mode()' ) )
 
 
   def OnCursorMoved( self ):
-    if self._user_options[ 'echo_current_diagnostic' ]:
+    if self._user_options.echo_current_diagnostic:
       line, _ = vimsupport.CurrentLineAndColumn()
       line += 1  # Convert to 1-based
       if not self.ShouldUpdateDiagnosticsUINow():
@@ -61,7 +66,7 @@ class DiagnosticInterface:
 
   def PopulateLocationList( self, open_on_edit = False ):
     # Do nothing if loc list is already populated by diag_interface
-    if not self._user_options[ 'always_populate_location_list' ]:
+    if not self._user_options.always_populate_location_list:
       self._UpdateLocationLists( open_on_edit )
     return bool( self._diagnostics )
 
@@ -76,23 +81,27 @@ class DiagnosticInterface:
 
 
   def RefreshDiagnosticsUI( self, open_on_edit = False ):
-    if self._user_options[ 'echo_current_diagnostic' ]:
+    if self._user_options.echo_current_diagnostic:
       self._EchoDiagnostic()
 
-    if self._user_options[ 'enable_diagnostic_signs' ]:
+    self.UpdateSignsAndMatches()
+
+    if self._user_options.always_populate_location_list:
+      self._UpdateLocationLists( open_on_edit )
+
+
+  def UpdateSignsAndMatches( self ):
+    if self._user_options.enable_diagnostic_signs:
       self._UpdateSigns()
 
     self.UpdateMatches()
 
-    if self._user_options[ 'always_populate_location_list' ]:
-      self._UpdateLocationLists( open_on_edit )
-
 
   def ClearDiagnosticsUI( self ):
-    if self._user_options[ 'echo_current_diagnostic' ]:
+    if self._user_options.echo_current_diagnostic:
       self._ClearCurrentDiagnostic()
 
-    if self._user_options[ 'enable_diagnostic_signs' ]:
+    if self._user_options.enable_diagnostic_signs:
       self._ClearSigns()
 
     self._ClearMatches()
@@ -134,7 +143,7 @@ class DiagnosticInterface:
       return
 
     if ( vimsupport.VimSupportsVirtualText() and
-         self._user_options[ 'echo_current_diagnostic' ] == 'virtual-text' ):
+         self._user_options.echo_current_diagnostic == 'virtual-text' ):
       tp.ClearTextProperties( self._bufnr,
                               prop_types = [ 'YcmVirtDiagPadding',
                                              'YcmVirtDiagError',
@@ -150,7 +159,7 @@ class DiagnosticInterface:
     self._ClearCurrentDiagnostic( bool( text ) )
 
     if ( vimsupport.VimSupportsVirtualText() and
-         self._user_options[ 'echo_current_diagnostic' ] == 'virtual-text' ):
+         self._user_options.echo_current_diagnostic == 'virtual-text' ):
       if not text:
         return
 
@@ -208,11 +217,11 @@ class DiagnosticInterface:
 
 
   def UpdateMatches( self ):
-    if not self._user_options[ 'enable_diagnostic_highlighting' ]:
+    if not self._user_options.enable_diagnostic_highlighting:
       return
 
     props_to_remove = vimsupport.GetTextProperties( self._bufnr )
-    for diags in self._line_to_diags.values():
+    for _, diags in self._DisplayedLinesAndDiagnostics():
       # Insert squiggles in reverse order so that errors overlap warnings.
       for diag in reversed( diags ):
         for line, column, name, extras in _ConvertDiagnosticToTextProperties(
@@ -252,7 +261,7 @@ class DiagnosticInterface:
   def _UpdateSigns( self ):
     signs_to_unplace = vimsupport.GetSignsInBuffer( self._bufnr )
     signs_to_place = []
-    for line, diags in self._line_to_diags.items():
+    for line, diags in self._DisplayedLinesAndDiagnostics():
       if not diags:
         continue
 
@@ -274,6 +283,21 @@ class DiagnosticInterface:
     vim.eval( f'sign_unplacelist( { signs_to_unplace } )' )
 
 
+  def _DisplayedLinesAndDiagnostics( self ):
+    """Returns the lines with diagnostics to display. In large files, only the
+    lines around the ones displayed in a window are shown; the diagnostics UI is
+    refreshed when windows are scrolled."""
+    if not vimsupport.IsLargeFile( self._bufnr ):
+      return self._line_to_diags.items()
+    visible_range = vimsupport.RangeVisibleInBuffer( self._bufnr )
+    if visible_range is None:
+      return []
+    start = visible_range[ 'start' ][ 'line_num' ]
+    end = visible_range[ 'end' ][ 'line_num' ]
+    return [ ( line, diags ) for line, diags in self._line_to_diags.items()
+             if start <= line <= end ]
+
+
   def _ConvertDiagListToDict( self ):
     self._line_to_diags = defaultdict( list )
     for diag in self._diagnostics:
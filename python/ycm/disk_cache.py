@@ -0,0 +1,64 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+import json
+import logging
+import os
+import tempfile
+from ycmd import utils
+
+# Helpers to persist data across Vim sessions in the user's cache directory.
+# Cache files are JSON objects storing the data along with a key describing
+# what it was computed from; the data is ignored when the key doesn't match.
+
+_logger = logging.getLogger( __name__ )
+
+
+def CacheDirectory( name ):
+  if utils.OnWindows():
+    cache_home = os.environ.get( 'LOCALAPPDATA' ) or tempfile.gettempdir()
+  else:
+    cache_home = ( os.environ.get( 'XDG_CACHE_HOME' ) or
+                   os.path.join( os.path.expanduser( '~' ), '.cache' ) )
+  return os.path.join( cache_home, 'ycm', name )
+
+
+def Load( cache_file, key ):
+  """Returns the data stored in |cache_file| for |key| or None if there is no
+  such data."""
+  try:
+    with open( cache_file ) as cache_file_handle:
+      cache = json.load( cache_file_handle )
+    if cache[ 'key' ] != key:
+      return None
+    return cache[ 'data' ]
+  except ( OSError, ValueError, KeyError, TypeError ):
+    return None
+
+
+def Save( cache_file, key, data ):
+  # Write to a temporary file then rename it so that another Vim instance never
+  # reads a partially written cache.
+  temp_file = f'{ cache_file }.{ os.getpid() }'
+  try:
+    os.makedirs( os.path.dirname( cache_file ), exist_ok = True )
+    with open( temp_file, 'w' ) as cache_file_handle:
+      json.dump( { 'key': key, 'data': data }, cache_file_handle )
+    os.replace( temp_file, cache_file )
+  except OSError:
+    _logger.exception( 'Failed to write cache %s', cache_file )
+    utils.RemoveIfExists( temp_file )
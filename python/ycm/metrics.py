@@ -0,0 +1,123 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+import sys
+import threading
+from collections import defaultdict
+
+# Counters and gauges of the client, grouped by section, shown by :YcmStats.
+# They are updated from the request threads too, hence the lock.
+
+_lock = threading.Lock()
+_counters = defaultdict( lambda: defaultdict( int ) )
+# Maps a gauge to its current and maximum values.
+_gauges = {}
+
+# Calls from these modules to Vim are counted for their caller.
+_BRIDGE_MODULES = { __name__, 'ycm.vimsupport' }
+
+
+def Increment( section, name, value = 1 ):
+  with _lock:
+    _counters[ section ][ name ] += value
+
+
+def RecordCacheLookup( cache, hit ):
+  Increment( 'cache_hits' if hit else 'cache_misses', cache )
+
+
+def AddToGauge( name, value ):
+  with _lock:
+    current, maximum = _gauges.get( name, ( 0, 0 ) )
+    current += value
+    _gauges[ name ] = ( current, max( current, maximum ) )
+
+
+def Snapshot():
+  with _lock:
+    snapshot = { section: dict( counters )
+                 for section, counters in _counters.items() }
+    gauges = dict( _gauges )
+
+  hits = snapshot.get( 'cache_hits', {} )
+  misses = snapshot.get( 'cache_misses', {} )
+  hit_rates = {}
+  for cache in sorted( set( hits ) | set( misses ) ):
+    hit_rates[ cache ] = hits.get( cache, 0 ) / ( hits.get( cache, 0 ) +
+                                                  misses.get( cache, 0 ) )
+  if hit_rates:
+    snapshot[ 'cache_hit_rates' ] = hit_rates
+
+  if gauges:
+    snapshot[ 'gauges' ] = {}
+    for name, ( current, maximum ) in sorted( gauges.items() ):
+      snapshot[ 'gauges' ][ name ] = current
+      snapshot[ 'gauges' ][ f'{ name }_max' ] = maximum
+  return snapshot
+
+
+def FormatReport( stats ):
+  if not stats:
+    return 'No statistics recorded.'
+
+  lines = []
+  for section, values in sorted( stats.items() ):
+    if not isinstance( values, dict ):
+      lines.append( f'{ section }: { _FormatValue( values ) }' )
+      continue
+    lines.append( f'{ section }:' )
+    for name, value in sorted( values.items() ):
+      lines.append( f'  { name }: { _FormatValue( value ) }' )
+  return '\n'.join( lines )
+
+
+def _FormatValue( value ):
+  if isinstance( value, float ):
+    return f'{ value:.3f}'
+  if isinstance( value, dict ):
+    return ', '.join( f'{ name } { _FormatValue( item ) }'
+                      for name, item in value.items() )
+  return str( value )
+
+
+def _CallerSubsystem():
+  frame = sys._getframe( 2 )
+  while frame and frame.f_globals.get( '__name__' ) in _BRIDGE_MODULES:
+    frame = frame.f_back
+  if not frame:
+    return 'unknown'
+  module_name = frame.f_globals.get( '__name__', 'unknown' )
+  if module_name.startswith( 'ycm.' ):
+    return module_name[ len( 'ycm.' ) : ]
+  return module_name
+
+
+def _CountCalls( section, function ):
+  def CountedFunction( *args, **kwargs ):
+    Increment( section, _CallerSubsystem() )
+    return function( *args, **kwargs )
+  return CountedFunction
+
+
+def InstrumentVimBridge( vim_module ):
+  """Counts the calls to vim.eval and vim.command per calling module, calls
+  made through vimsupport being counted for the module calling it."""
+  if getattr( vim_module, '_ycm_instrumented', False ):
+    return
+  vim_module.eval = _CountCalls( 'vim_eval_calls', vim_module.eval )
+  vim_module.command = _CountCalls( 'vim_command_calls', vim_module.command )
+  vim_module._ycm_instrumented = True
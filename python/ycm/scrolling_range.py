@@ -17,7 +17,7 @@
 
 import abc
 
-from ycm import vimsupport
+from ycm import metrics, vimsupport
 
 
 class ScrollingBufferRange( object ):
@@ -85,6 +85,7 @@ class ScrollingBufferRange( object ):
 
     if self._tick != vimsupport.GetBufferChangedTick( self._bufnr ):
       # Buffer has changed, we should ignore the data and retry
+      metrics.Increment( 'dropped_responses', type( self ).__name__ )
       self.Request( force=True )
       return False # poll again
 
@@ -0,0 +1,231 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+import base64
+import contextlib
+import json
+import logging
+import os
+import stat
+import tempfile
+from ycmd import utils
+
+# When the g:ycm_shared_server option is set, the first Vim instance starts a
+# ycmd server and publishes its location and HMAC secret in a per-user state
+# directory. Later instances attach to that server instead of spawning their
+# own, so that the semantic engines (clangd, jdt.ls, etc.) and their indexes
+# are only loaded once. Each attached instance registers itself in the clients
+# subdirectory; the server is only shut down when the last client leaves.
+#
+# The state directory must be private: anyone able to write to it could make
+# Vim send the buffers and the HMAC secret to a server they control. It lives in
+# $XDG_RUNTIME_DIR when available, otherwise in the shared temporary directory
+# where another user could have created it first, so its owner and mode are
+# checked before it's used and files are never created through symlinks.
+STATE_DIRNAME = 'ycm_shared_server'
+STATE_FILENAME = 'server.json'
+LOCK_FILENAME = 'server.lock'
+CLIENTS_DIRNAME = 'clients'
+
+_logger = logging.getLogger( __name__ )
+
+
+def IsSupported():
+  # Process liveness checks and file locking are only implemented for POSIX
+  # systems.
+  return not utils.OnWindows()
+
+
+class UnsafeStateDirectory( OSError ):
+  pass
+
+
+def StateDirectory():
+  runtime_dir = os.environ.get( 'XDG_RUNTIME_DIR' )
+  if runtime_dir and os.path.isdir( runtime_dir ):
+    return os.path.join( runtime_dir, STATE_DIRNAME )
+  return os.path.join( tempfile.gettempdir(),
+                       f'{ STATE_DIRNAME }_{ os.getuid() }' )
+
+
+def _EnsureDirectory( path ):
+  """Creates the private directory |path| if needed. Raises
+  UnsafeStateDirectory if it's not a directory owned by the current user and
+  only accessible to them."""
+  try:
+    os.mkdir( path, 0o700 )
+  except FileExistsError:
+    pass
+  # Don't follow a symlink planted by another user.
+  path_stat = os.lstat( path )
+  if not stat.S_ISDIR( path_stat.st_mode ):
+    raise UnsafeStateDirectory( f'{ path } is not a directory' )
+  if path_stat.st_uid != os.getuid():
+    raise UnsafeStateDirectory( f'{ path } is owned by another user' )
+  if stat.S_IMODE( path_stat.st_mode ) != 0o700:
+    raise UnsafeStateDirectory( f'{ path } is accessible to other users' )
+
+
+def PrepareStateDirectory():
+  """Creates the state directory if needed and returns whether it can be used
+  to share a server."""
+  try:
+    _EnsureDirectory( StateDirectory() )
+    _EnsureDirectory( _ClientsDirectory() )
+  except OSError as error:
+    _logger.warning( 'Not sharing the ycmd server: %s', error )
+    return False
+  return True
+
+
+def _CreatePrivateFile( path, flags = os.O_WRONLY ):
+  """Opens |path| for writing, creating it only readable by the current user.
+  Never follows a symlink."""
+  return os.open( path, flags | os.O_CREAT | os.O_NOFOLLOW, 0o600 )
+
+
+def ProcessIsAlive( pid ):
+  try:
+    os.kill( pid, 0 )
+  except ProcessLookupError:
+    return False
+  except PermissionError:
+    # The process belongs to another user so it's neither a server nor a
+    # client started by the current user; the PID was reused.
+    return False
+  return True
+
+
+class AttachedServerProcess:
+  """Mimics the subset of the Popen interface used by the YouCompleteMe class
+  for a server that was started by another Vim instance."""
+
+  def __init__( self, pid ):
+    self.pid = pid
+
+
+  def poll( self ):
+    # We can't get the exit code of a process that is not our child.
+    return None if ProcessIsAlive( self.pid ) else -1
+
+
+@contextlib.contextmanager
+def StateLock():
+  """Serializes the attach-or-spawn decision between Vim instances so that two
+  editors started at the same time don't both spawn a server."""
+  import fcntl
+
+  state_dir = StateDirectory()
+  _EnsureDirectory( state_dir )
+  lock_file_descriptor = _CreatePrivateFile(
+    os.path.join( state_dir, LOCK_FILENAME ) )
+  with os.fdopen( lock_file_descriptor, 'w' ) as lock_file:
+    fcntl.flock( lock_file, fcntl.LOCK_EX )
+    try:
+      yield
+    finally:
+      fcntl.flock( lock_file, fcntl.LOCK_UN )
+
+
+def ReadServerState():
+  """Returns the state published by the Vim instance that started the shared
+  server, or None if there is no such server or it is not running anymore."""
+  state_file = os.path.join( StateDirectory(), STATE_FILENAME )
+  try:
+    _EnsureDirectory( StateDirectory() )
+    file_descriptor = os.open( state_file, os.O_RDONLY | os.O_NOFOLLOW )
+    with os.fdopen( file_descriptor ) as state_file_handle:
+      state = json.load( state_file_handle )
+    state[ 'hmac_secret' ] = base64.b64decode( state[ 'hmac_secret' ] )
+    pid = int( state[ 'pid' ] )
+  except ( OSError, ValueError, KeyError, TypeError ):
+    return None
+
+  if not ProcessIsAlive( pid ):
+    _logger.info( 'Shared ycmd server with PID %s is gone', pid )
+    utils.RemoveIfExists( state_file )
+    return None
+
+  return state
+
+
+def PublishServerState( server_location,
+                        hmac_secret,
+                        pid,
+                        logfiles,
+                        state_dir = None ):
+  """Publishes the server in |state_dir|, which defaults to the state directory
+  of the current process."""
+  if state_dir is None:
+    state_dir = StateDirectory()
+  _EnsureDirectory( state_dir )
+  state = {
+    'server_location': server_location,
+    'hmac_secret': utils.ToUnicode( base64.b64encode( hmac_secret ) ),
+    'pid': pid,
+    'logfiles': logfiles
+  }
+  # The state contains the HMAC secret so it must only be readable by the
+  # current user. Write to a temporary file then rename it to avoid other
+  # instances reading a partially written file. The temporary file may be left
+  # over by a Vim instance that crashed.
+  temp_file = os.path.join( state_dir, f'{ STATE_FILENAME }.{ os.getpid() }' )
+  utils.RemoveIfExists( temp_file )
+  file_descriptor = _CreatePrivateFile( temp_file, os.O_WRONLY | os.O_EXCL )
+  with os.fdopen( file_descriptor, 'w' ) as state_file_handle:
+    json.dump( state, state_file_handle )
+  os.replace( temp_file, os.path.join( state_dir, STATE_FILENAME ) )
+
+
+def ClearServerState():
+  utils.RemoveIfExists( os.path.join( StateDirectory(), STATE_FILENAME ) )
+
+
+def _ClientsDirectory():
+  return os.path.join( StateDirectory(), CLIENTS_DIRNAME )
+
+
+def RegisterClient():
+  clients_dir = _ClientsDirectory()
+  _EnsureDirectory( clients_dir )
+  os.close( _CreatePrivateFile( os.path.join( clients_dir,
+                                              str( os.getpid() ) ) ) )
+
+
+def UnregisterClient():
+  """Removes the current Vim instance from the list of clients of the shared
+  server. Returns the number of other clients still alive."""
+  clients_dir = _ClientsDirectory()
+  utils.RemoveIfExists( os.path.join( clients_dir, str( os.getpid() ) ) )
+
+  try:
+    client_pids = os.listdir( clients_dir )
+  except OSError:
+    return 0
+
+  live_clients = 0
+  for client_pid in client_pids:
+    try:
+      alive = ProcessIsAlive( int( client_pid ) )
+    except ValueError:
+      alive = False
+    if alive:
+      live_clients += 1
+    else:
+      # Vim crashed or was killed before it could unregister.
+      utils.RemoveIfExists( os.path.join( clients_dir, client_pid ) )
+  return live_clients
@@ -17,11 +17,17 @@
 
 import vim
 import json
+import re
 from ycm import vimsupport
 from ycmd import utils
 from ycm.vimsupport import memoize, GetIntValue
 
 
+# Characters after which the argument being typed can't be found by counting
+# commas.
+NESTING_CHARACTERS_REGEX = re.compile( rb'[()\[\]{}<>"\']' )
+
+
 class SignatureHelpState:
   ACTIVE = 'ACTIVE'
   INACTIVE = 'INACTIVE'
@@ -50,6 +56,15 @@ class SignatureHelpState:
     return 'INACTIVE'
 
 
+def ArgumentIndex( text ):
+  """Returns the index of the argument being typed at the end of |text|, the
+  bytes between the anchor of the signature help and the cursor, or None if it
+  can't be told without parsing the arguments (nested calls, strings, etc.)."""
+  if NESTING_CHARACTERS_REGEX.search( text ):
+    return None
+  return text.count( b',' )
+
+
 def _MakeSignatureHelpBuffer( signature_info ):
   active_parameter = int( signature_info.get( 'activeParameter', 0 ) )
 
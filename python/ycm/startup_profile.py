@@ -0,0 +1,58 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+import contextlib
+import time
+
+# This module must stay cheap to import since it is loaded before anything else
+# to measure how long the other modules take to load.
+
+# Maps a startup phase to its duration in seconds. Only the first occurrence of
+# each phase is recorded so that restarting the server doesn't overwrite the
+# startup measurements.
+_PHASES = {}
+
+
+def Now():
+  return time.perf_counter()
+
+
+def RecordSeconds( phase, seconds ):
+  _PHASES.setdefault( phase, float( seconds ) )
+
+
+def Record( phase, start_time ):
+  RecordSeconds( phase, Now() - start_time )
+
+
+@contextlib.contextmanager
+def Measure( phase ):
+  start_time = Now()
+  try:
+    yield
+  finally:
+    Record( phase, start_time )
+
+
+def FormatReport():
+  if not _PHASES:
+    return 'No startup measurements recorded.'
+
+  width = max( len( phase ) for phase in _PHASES )
+  lines = [ f'{ phase.ljust( width ) } { seconds * 1000:8.1f} ms'
+            for phase, seconds in _PHASES.items() ]
+  return '\n'.join( lines )
@@ -0,0 +1,152 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+import json
+import os
+import re
+from ycm import disk_cache, metrics, vimsupport
+
+# Extracting the keywords from the output of ":syntax list" can take a long
+# time for filetypes with large syntax definitions. The keywords are cached on
+# disk, one file per filetype, along with the paths, modification times, and
+# sizes of the syntax files Vim loads for that filetype (see ":h :syn-files")
+# and for the filetypes whose syntax they include (e.g. the C syntax for C++),
+# and the values of the global variables configuring these syntaxes (e.g.
+# g:c_no_curly_error). The cache is invalidated when any of them changes or when
+# Vim is upgraded, since syntax files commonly include other runtime files.
+CACHE_VERSION = 3
+
+# Filetypes are used as filenames so we don't cache the unusual ones.
+FILETYPE_REGEX = re.compile( r'^[\w-]+$' )
+
+# Matches the syntax files included with ":runtime! syntax/c.vim" or
+# ":syntax include @Html syntax/html.vim".
+INCLUDED_SYNTAX_REGEX = re.compile(
+  r'^\s*(?:ru[a-z]*!?|syn(?:tax)?\s+include\s+@\w+)\s+'
+  r'syntax/(?P<filetype>[\w-]+)\.vim\b',
+  re.MULTILINE )
+
+# Avoids reading the same cache file more than once per session.
+_keywords_for_key = {}
+
+
+def CacheDirectory():
+  return disk_cache.CacheDirectory( 'syntax_keywords' )
+
+
+def SyntaxKeywordsForCurrentBuffer( filetype ):
+  """Returns the set of keywords defined by the syntax of the current buffer,
+  using the cached keywords for |filetype| when its syntax files haven't
+  changed."""
+  if not FILETYPE_REGEX.match( filetype ):
+    return _ExtractKeywords()
+
+  key = _CacheKey( filetype )
+  if key is None:
+    return _ExtractKeywords()
+
+  memory_key = json.dumps( key )
+  keywords = _keywords_for_key.get( memory_key )
+  if keywords is None:
+    keywords = _LoadKeywords( filetype, key )
+  metrics.RecordCacheLookup( 'syntax_keywords', keywords is not None )
+  if keywords is None:
+    keywords = _ExtractKeywords()
+    _SaveKeywords( filetype, key, keywords )
+  _keywords_for_key[ memory_key ] = keywords
+  return keywords
+
+
+def _ExtractKeywords():
+  from ycm import syntax_parse
+  return syntax_parse.SyntaxKeywordsForCurrentBuffer()
+
+
+def _SyntaxFiles( filetype ):
+  # This is how Vim finds the syntax files of a filetype.
+  return vimsupport.GetVariableValue(
+    f"globpath( &runtimepath, 'syntax/{ filetype }.vim', 0, 1 ) + "
+    f"globpath( &runtimepath, 'syntax/{ filetype }/*.vim', 0, 1 )" )
+
+
+def _IncludedFiletypes( syntax_file ):
+  try:
+    with open( syntax_file, encoding = 'utf8', errors = 'replace' ) as f:
+      contents = f.read()
+  except OSError:
+    return []
+  return [ match.group( 'filetype' )
+           for match in INCLUDED_SYNTAX_REGEX.finditer( contents ) ]
+
+
+def _SyntaxFilesAndFiletypes( filetype ):
+  """Returns the syntax files loaded for |filetype|, including those of the
+  filetypes whose syntax is included by these files, and all these filetypes."""
+  syntax_files = []
+  filetypes = [ filetype ]
+  for current_filetype in filetypes:
+    for syntax_file in _SyntaxFiles( current_filetype ):
+      if syntax_file in syntax_files:
+        continue
+      syntax_files.append( syntax_file )
+      for included_filetype in _IncludedFiletypes( syntax_file ):
+        if included_filetype not in filetypes:
+          filetypes.append( included_filetype )
+  return syntax_files, filetypes
+
+
+def _SyntaxVariables( filetypes ):
+  # Syntax files are configured with variables named after the filetype, e.g.
+  # g:c_gnu or g:cpp_no_cpp17.
+  return sorted( [ f'{ filetype }_{ name }', str( value ) ]
+                 for filetype in filetypes
+                 for name, value in vimsupport.GetVimGlobalsWithPrefix(
+                   f'{ filetype }_' ).items() )
+
+
+def _CacheKey( filetype ):
+  syntax_files = []
+  paths, filetypes = _SyntaxFilesAndFiletypes( filetype )
+  for syntax_file in paths:
+    try:
+      stat = os.stat( syntax_file )
+    except OSError:
+      continue
+    syntax_files.append( [ syntax_file, stat.st_mtime_ns, stat.st_size ] )
+  # The syntax is not defined by syntax files so we can't tell when it changes.
+  if not syntax_files:
+    return None
+  return {
+    'version': CACHE_VERSION,
+    'filetype': filetype,
+    'vim_version': vimsupport.GetIntValue( 'v:versionlong' ),
+    'syntax_files': syntax_files,
+    'variables': _SyntaxVariables( filetypes )
+  }
+
+
+def _CacheFile( filetype ):
+  return os.path.join( CacheDirectory(), f'{ filetype }.json' )
+
+
+def _LoadKeywords( filetype, key ):
+  keywords = disk_cache.Load( _CacheFile( filetype ), key )
+  return None if keywords is None else set( keywords )
+
+
+def _SaveKeywords( filetype, key, keywords ):
+  disk_cache.Save( _CacheFile( filetype ), key, sorted( keywords ) )
@@ -15,6 +15,7 @@
 # You should have received a copy of the GNU General Public License
 # along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
 
+import io
 import re
 from ycm import vimsupport
 
@@ -36,6 +37,8 @@ SYNTAX_ARGUMENT_REGEX = re.compile(
 SYNTAX_REGION_ARGUMENT_REGEX = re.compile(
   r"^(?:matchgroup|start)=.*$" )
 
+LINKS_TO = 'links to '
+
 # See ":h syn-nextgroup".
 SYNTAX_NEXTGROUP_ARGUMENTS = {
   'skipwhite',
@@ -67,50 +70,62 @@ def SyntaxKeywordsForCurrentBuffer():
 
 def _KeywordsFromSyntaxListOutput( syntax_output ):
   group_name_to_group = _SyntaxGroupsFromOutput( syntax_output )
-  _ConnectGroupChildren( group_name_to_group )
 
-  groups_with_keywords = []
+  # Groups reachable from several roots are only visited once.
+  visited = set()
+  keywords = set()
   for root_group in ROOT_GROUPS:
-    groups_with_keywords.extend(
-      _GetAllDescendentats( group_name_to_group[ root_group ] ) )
-
-  keywords = []
-  for group in groups_with_keywords:
-    keywords.extend( _ExtractKeywordsFromGroup( group ) )
-  return set( keywords )
+    for group in _GetAllDescendants( group_name_to_group[ root_group ],
+                                     visited ):
+      keywords.update( _ExtractKeywordsFromGroup( group ) )
+  return keywords
 
 
 def _SyntaxGroupsFromOutput( syntax_output ):
+  """Parses the output of ":syntax list" in a single pass over its lines,
+  connecting each group to the groups it links to as they are read."""
   group_name_to_group = _CreateInitialGroupMap()
-  lines               = syntax_output.split( '\n' )
-  looking_for_group   = True
+  parent_names = []
 
   current_group = None
-  for line in lines:
+  # Iterate over the lines lazily; the output can be several megabytes long.
+  for line in io.StringIO( syntax_output ):
+    line = line.rstrip( '\n' )
     if not line:
       continue
 
+    if line[ 0 ] == ' ' or line[ 0 ] == '\t':
+      if current_group is not None:
+        _AddLineToGroup( current_group, line.strip(), parent_names )
+      continue
+
     match = SYNTAX_GROUP_REGEX.search( line )
-    if match:
-      if looking_for_group:
-        looking_for_group = False
-      else:
-        group_name_to_group[ current_group.name ] = current_group
-
-      current_group = SyntaxGroup( match.group( 'group_name' ),
-                                   [ match.group( 'content' ).strip() ] )
-    else:
-      if looking_for_group:
-        continue
+    if not match:
+      continue
 
-      if line[ 0 ] == ' ' or line[ 0 ] == '\t':
-        current_group.lines.append( line.strip() )
+    group_name = match.group( 'group_name' )
+    current_group = group_name_to_group.get( group_name )
+    if current_group is None:
+      current_group = group_name_to_group[ group_name ] = SyntaxGroup(
+        group_name )
+    _AddLineToGroup( current_group,
+                     match.group( 'content' ).strip(),
+                     parent_names )
+
+  for group, parent_name in parent_names:
+    parent_group = group_name_to_group.get( parent_name )
+    if parent_group is not None:
+      parent_group.children.append( group )
 
-  if current_group:
-    group_name_to_group[ current_group.name ] = current_group
   return group_name_to_group
 
 
+def _AddLineToGroup( group, line, parent_names ):
+  group.lines.append( line )
+  if line.startswith( LINKS_TO ):
+    parent_names.append( ( group, line[ len( LINKS_TO ): ] ) )
+
+
 def _CreateInitialGroupMap():
   def AddToGroupMap( name, parent ):
     new_group = SyntaxGroup( name )
@@ -152,36 +167,23 @@ def _CreateInitialGroupMap():
   return group_name_to_group
 
 
-def _ConnectGroupChildren( group_name_to_group ):
-  def GetParentNames( group ):
-    links_to     = 'links to '
-    parent_names = []
-    for line in group.lines:
-      if line.startswith( links_to ):
-        parent_names.append( line[ len( links_to ): ] )
-    return parent_names
-
-  for group in group_name_to_group.values():
-    parent_names = GetParentNames( group )
-
-    for parent_name in parent_names:
-      try:
-        parent_group = group_name_to_group[ parent_name ]
-      except KeyError:
+def _GetAllDescendants( root_group, visited ):
+  """Yields the descendants of |root_group| that are not in |visited|, adding
+  them to it. Iterative so that long chains of links can't exceed the
+  recursion limit, and cycles of links are only followed once."""
+  stack = [ root_group ]
+  while stack:
+    group = stack.pop()
+    for child in group.children:
+      if child.name in visited:
         continue
-      parent_group.children.append( group )
-
-
-def _GetAllDescendentats( root_group ):
-  descendants = []
-  for child in root_group.children:
-    descendants.append( child )
-    descendants.extend( _GetAllDescendentats( child ) )
-  return descendants
+      visited.add( child.name )
+      yield child
+      stack.append( child )
 
 
 def _ExtractKeywordsFromLine( line ):
-  if line.startswith( 'links to ' ):
+  if line.startswith( LINKS_TO ):
     return []
 
   # Ignore "syntax match" lines (see ":h syn-match").
@@ -53,6 +53,13 @@ DEFAULT_CLIENT_OPTIONS = {
   'g:ycm_seed_identifiers_with_syntax': 0,
   'g:ycm_goto_buffer_command': 'same-buffer',
   'g:ycm_update_diagnostics_in_insert_mode': 1,
+  'g:ycm_shared_server': 0,
+  'g:ycm_server_standby': 0,
+  'g:ycm_server_auto_restart': 1,
+  'g:ycm_prefetch_buffers': 0,
+  'g:ycm_compress_requests_larger_than_kb': 0,
+  'g:ycm_stats_file': '',
+  'g:ycm_count_vim_calls': 0,
   # ycmd options
   'g:ycm_auto_trigger': 1,
   'g:ycm_min_num_of_chars_for_completion': 2,
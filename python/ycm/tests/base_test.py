@@ -47,6 +47,37 @@ def MockTextAfterCursor( text ):
 
 
 class BaseTest( TestCase ):
+  @patch( 'ycm.base._ServerDefaultOptions',
+          return_value = { 'min_num_of_chars_for_completion': 2,
+                           'filetype_whitelist': { '*': 1 } } )
+  @patch( 'ycm.tests.test_utils.VIM_OPTIONS', {
+    'g:ycm_min_num_of_chars_for_completion': '3',
+    'g:ycm_log_level': 'debug',
+    'g:other_plugin_option': 1
+  } )
+  def test_GetUserOptions_OverrideDefaults( self, *args ):
+    options = base.GetUserOptions( { 'log_level': 'info', 'keep_logfiles': 0 } )
+    assert_that( dict( options ), equal_to( {
+      'min_num_of_chars_for_completion': 3,
+      'filetype_whitelist': { '*': 1 },
+      'log_level': 'debug',
+      'keep_logfiles': 0
+    } ) )
+    assert_that( options.min_num_of_chars_for_completion, equal_to( 3 ) )
+    assert_that( options[ 'log_level' ], equal_to( 'debug' ) )
+
+
+  def test_Options_ReadOnly( self ):
+    options = base.Options( { 'log_level': 'info' } )
+    with self.assertRaises( AttributeError ):
+      options.log_level = 'debug'
+    with self.assertRaises( TypeError ):
+      options[ 'log_level' ] = 'debug'
+    with self.assertRaises( AttributeError ):
+      del options.log_level
+    assert_that( options.log_level, equal_to( 'info' ) )
+
+
   def test_AdjustCandidateInsertionText_Basic( self ):
     with MockTextAfterCursor( 'bar' ):
       assert_that( [ { 'word': 'foo',    'abbr': 'foobar' } ],
@@ -231,6 +262,21 @@ class BaseTest( TestCase ):
         assert_that( base.LastEnteredCharIsIdentifierChar() )
 
 
+  def test_LastEnteredCharIsIdentifierChar_LongLine( self ):
+    line = 'a=b;' * 2500
+    with MockCurrentFiletypes():
+      with MockCurrentColumnAndLineContents( len( line ), line ):
+        assert_that( not base.LastEnteredCharIsIdentifierChar() )
+
+      with MockCurrentColumnAndLineContents( len( line ) - 1, line ):
+        assert_that( base.LastEnteredCharIsIdentifierChar() )
+
+      identifier = 'x' * ( 2 * base.MAX_IDENTIFIER_SCAN_LENGTH )
+      with MockCurrentColumnAndLineContents( len( line + identifier ),
+                                             line + identifier ):
+        assert_that( base.LastEnteredCharIsIdentifierChar() )
+
+
   def test_CurrentIdentifierFinished_Basic( self ):
     with MockCurrentFiletypes():
       with MockCurrentColumnAndLineContents( 3, 'ab;' ):
@@ -281,6 +327,31 @@ class BaseTest( TestCase ):
         assert_that( not base.CurrentIdentifierFinished() )
 
 
+  def test_CurrentIdentifierFinished_LongLine( self ):
+    line = 'a=b;' * 2500
+    with MockCurrentFiletypes():
+      with MockCurrentColumnAndLineContents( len( line ), line ):
+        assert_that( base.CurrentIdentifierFinished() )
+
+      with MockCurrentColumnAndLineContents( len( line ) - 1, line ):
+        assert_that( not base.CurrentIdentifierFinished() )
+
+      # Identifiers longer than the scanned text.
+      identifier = 'x' * ( 2 * base.MAX_IDENTIFIER_SCAN_LENGTH )
+      line_with_identifier = line + identifier + '.'
+      with MockCurrentColumnAndLineContents( len( line_with_identifier ),
+                                             line_with_identifier ):
+        assert_that( base.CurrentIdentifierFinished() )
+
+      with MockCurrentColumnAndLineContents( len( identifier ) + 1,
+                                             identifier + '.' ):
+        assert_that( base.CurrentIdentifierFinished() )
+
+      line = ' ' * 10000
+      with MockCurrentColumnAndLineContents( len( line ), line ):
+        assert_that( base.CurrentIdentifierFinished() )
+
+
   def test_CurrentIdentifierFinished_WhitespaceOnly( self ):
     with MockCurrentFiletypes():
       with MockCurrentColumnAndLineContents( 1, '\n' ):
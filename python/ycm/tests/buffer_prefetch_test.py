@@ -0,0 +1,144 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+from hamcrest import assert_that, contains_exactly, empty, equal_to
+from unittest import TestCase
+from unittest.mock import MagicMock, call, patch
+from ycm.buffer import Buffer
+from ycm.buffer_prefetch import AlternateFiles, BufferPrefetcher
+
+FILENAME_TO_BUFFER_NUMBER = {
+  '/src/foo.h': 2,
+  '/src/foo.hpp': -1,
+}
+
+
+def PrefetchedBuffers( event_notification ):
+  return [ kwargs[ 'buffer_number' ]
+           for _, _, kwargs in event_notification.mock_calls
+           if 'buffer_number' in kwargs ]
+
+
+@patch( 'ycm.vimsupport.GetCurrentBufferNumber', return_value = 1 )
+@patch( 'ycm.vimsupport.GetCurrentBufferFilepath',
+        return_value = '/src/foo.cc' )
+@patch( 'ycm.vimsupport.GetBufferNumberForFilename',
+        side_effect = lambda filepath: FILENAME_TO_BUFFER_NUMBER.get(
+          filepath, -1 ) )
+@patch( 'ycm.vimsupport.BufferIsVisible',
+        side_effect = lambda bufnr: bufnr == 5 )
+@patch( 'ycm.vimsupport.BufferIsLoaded',
+        side_effect = lambda bufnr: bufnr != 6 )
+@patch( 'ycm.vimsupport.GetBufferFiletypes',
+        side_effect = lambda bufnr: [ 'text' if bufnr == 7 else 'cpp' ] )
+@patch( 'ycm.vimsupport.GetBufferChangedTick', return_value = 1 )
+@patch( 'ycm.buffer.EventNotification' )
+class BufferPrefetchTest( TestCase ):
+  def _Prefetcher( self, max_buffers = 5 ):
+    buffers = {}
+
+    def GetBuffer( bufnr ):
+      if bufnr not in buffers:
+        buffers[ bufnr ] = Buffer( bufnr, MagicMock(), [ 'cpp' ] )
+      return buffers[ bufnr ]
+
+    return BufferPrefetcher( max_buffers,
+                             lambda filetypes: filetypes == [ 'cpp' ],
+                             GetBuffer )
+
+
+  def test_AlternateFiles( self, *args ):
+    assert_that( AlternateFiles( '/src/foo.cc' ),
+                 contains_exactly( '/src/foo.h', '/src/foo.hh', '/src/foo.hpp',
+                                   '/src/foo.hxx', '/src/foo.h++',
+                                   '/src/foo.inl', '/src/foo.ipp' ) )
+    assert_that( AlternateFiles( '/src/foo.H' )[ : 2 ],
+                 contains_exactly( '/src/foo.c', '/src/foo.cc' ) )
+    assert_that( AlternateFiles( '/src/foo.py' ), empty() )
+
+
+  def test_BufferPrefetcher_AlternateThenMostRecentlyUsedHiddenBuffers(
+      self, event_notification, *args ):
+    event_notification.return_value.Done.return_value = True
+    event_notification.return_value.Duration.return_value = 0.1
+    prefetcher = self._Prefetcher()
+    # Buffer 1 is current, 5 is visible, 6 is not loaded, and 7 has no semantic
+    # completer.
+    prefetcher.Start( [ 3, 2, 5, 6, 7, 4, 1 ], {} )
+    while prefetcher.Poll():
+      pass
+    assert_that( PrefetchedBuffers( event_notification ),
+                 contains_exactly( 2, 4, 3 ) )
+
+    # Unchanged buffers are not parsed again.
+    event_notification.reset_mock()
+    prefetcher.Start( [ 3, 2, 4, 1 ], {} )
+    while prefetcher.Poll():
+      pass
+    assert_that( PrefetchedBuffers( event_notification ), empty() )
+
+
+  def test_BufferPrefetcher_OneRequestAtATime( self, event_notification,
+                                               *args ):
+    parse_request = event_notification.return_value
+    parse_request.Done.return_value = False
+    prefetcher = self._Prefetcher()
+    prefetcher.Start( [ 3, 4 ], {} )
+    assert_that( prefetcher.Poll(), equal_to( True ) )
+    assert_that( prefetcher.Poll(), equal_to( True ) )
+    assert_that( PrefetchedBuffers( event_notification ),
+                 contains_exactly( 2 ) )
+
+    # Stopping doesn't cancel the request in flight but no other is sent.
+    prefetcher.Stop()
+    parse_request.Done.return_value = True
+    assert_that( prefetcher.Poll(), equal_to( False ) )
+    assert_that( PrefetchedBuffers( event_notification ),
+                 contains_exactly( 2 ) )
+
+
+  @patch( 'ycm.buffer_prefetch.PREFETCH_BUDGET_SECONDS', 1 )
+  def test_BufferPrefetcher_Budget( self, event_notification, *args ):
+    event_notification.return_value.Done.return_value = True
+    event_notification.return_value.Duration.return_value = 0.6
+    prefetcher = self._Prefetcher()
+    prefetcher.Start( [ 3, 4 ], {} )
+    while prefetcher.Poll():
+      pass
+    assert_that( PrefetchedBuffers( event_notification ),
+                 contains_exactly( 2, 4 ) )
+
+
+  def test_BufferPrefetcher_MaxBuffers( self, event_notification, *args ):
+    event_notification.return_value.Done.return_value = True
+    event_notification.return_value.Duration.return_value = 0.1
+    prefetcher = self._Prefetcher( max_buffers = 1 )
+    prefetcher.Start( [ 3, 4 ], { 'extra': 'data' } )
+    while prefetcher.Poll():
+      pass
+    assert_that( event_notification.call_args_list,
+                 contains_exactly( call( 'FileReadyToParse',
+                                         buffer_number = 2,
+                                         extra_data = { 'extra': 'data' },
+                                         on_success = None ) ) )
+
+    prefetcher = self._Prefetcher( max_buffers = 0 )
+    prefetcher.Start( [ 3, 4 ], {} )
+    assert_that( prefetcher.Poll(), equal_to( False ) )
@@ -0,0 +1,196 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+from hamcrest import assert_that, contains_exactly, equal_to, greater_than
+from concurrent.futures import Future
+from unittest import TestCase
+from unittest.mock import MagicMock, patch
+from ycm.buffer import Buffer, BufferDict
+
+
+@patch( 'ycm.vimsupport.GetBufferFiletypes', return_value = [ 'cpp' ] )
+class BufferTest( TestCase ):
+  def test_Buffer_DiagnosticInterfaceCreatedOnDemand( self, *args ):
+    buffer = Buffer( 1, MagicMock(), [ 'cpp' ] )
+    assert_that( buffer._diag_interface, equal_to( None ) )
+    assert_that( buffer.GetErrorCount(), equal_to( 0 ) )
+    assert_that( buffer.GetWarningCount(), equal_to( 0 ) )
+    assert_that( buffer.DiagnosticsForLine( 1 ), equal_to( [] ) )
+    assert_that( buffer._diag_interface, equal_to( None ) )
+
+    size = buffer.MemoryUsage()
+    buffer.diag_interface._diagnostics = [ { 'text': 'error' * 100 } ]
+    assert_that( buffer.MemoryUsage(), greater_than( size ) )
+
+
+  @patch( 'ycm.vimsupport.GetBufferChangedTick', return_value = 1 )
+  @patch( 'ycm.buffer.EventNotification' )
+  def test_Buffer_ParseDelay( self, event_notification, *args ):
+    buffer = Buffer( 1, MagicMock(), [ 'cpp' ] )
+    assert_that( buffer.ParseDelay(), equal_to( 0 ) )
+
+    parse_request = event_notification.return_value
+    parse_request.Done.return_value = False
+    parse_request.Duration.return_value = None
+    buffer.SendParseRequest( {} )
+    assert_that( buffer.ParseDelay(), equal_to( 0 ) )
+
+    # Fast parses are not delayed.
+    parse_request.Done.return_value = True
+    parse_request.Duration.return_value = 0.02
+    assert_that( buffer.ParseDelay(), equal_to( 0 ) )
+
+    # The delay follows the parse duration.
+    buffer.SendParseRequest( {} )
+    parse_request.Duration.return_value = 1.02
+    assert_that( buffer.ParseDelay(), equal_to( 135 ) )
+    assert_that( buffer.ParseDelay(), equal_to( 135 ) )
+
+    for _ in range( 50 ):
+      buffer.SendParseRequest( {} )
+      buffer.ParseDelay()
+    assert_that( buffer.ParseDelay(), equal_to( 509 ) )
+
+    # The delay is capped.
+    for _ in range( 50 ):
+      buffer.SendParseRequest( {} )
+      parse_request.Duration.return_value = 60
+      buffer.ParseDelay()
+    assert_that( buffer.ParseDelay(), equal_to( 2000 ) )
+
+
+  @patch( 'ycm.buffer.EventNotification' )
+  def test_Buffer_UsePrefetchedParse( self, event_notification, *args ):
+    with patch( 'ycm.vimsupport.GetBufferChangedTick',
+                return_value = 1 ) as changed_tick:
+      buffer = Buffer( 2, MagicMock(), [ 'cpp' ] )
+      buffer.SendParseRequest( {}, prefetch = True )
+      event_notification.assert_called_once_with( 'FileReadyToParse',
+                                                  buffer_number = 2,
+                                                  extra_data = {},
+                                                  on_success = None )
+      assert_that( buffer.IsPrefetched(), equal_to( True ) )
+      # The response is handled when entering the buffer.
+      assert_that( buffer.IsResponseHandled(), equal_to( False ) )
+
+      # The prefetched parse is only used once.
+      assert_that( buffer.UsePrefetchedParse(), equal_to( True ) )
+      assert_that( buffer.UsePrefetchedParse(), equal_to( False ) )
+
+      # It isn't used if the buffer changed since.
+      buffer.SendParseRequest( {}, prefetch = True )
+      changed_tick.return_value = 2
+      assert_that( buffer.UsePrefetchedParse(), equal_to( False ) )
+
+      # Nor after a regular parse.
+      buffer.SendParseRequest( {}, prefetch = True )
+      buffer.SendParseRequest( {} )
+      assert_that( buffer.UsePrefetchedParse(), equal_to( False ) )
+
+
+  @patch( 'ycm.vimsupport.GetBufferChangedTick', return_value = 1 )
+  @patch( 'ycm.client.event_notification.BuildRequestData', return_value = {} )
+  @patch( 'ycm.client.event_notification.EventNotification.'
+          'PostDataToHandlerAsync' )
+  def test_Buffer_SendParseRequest_OnSuccess( self,
+                                              post_data_to_handler_async,
+                                              *args ):
+    buffer = Buffer( 1, MagicMock(), [ 'cpp' ] )
+    on_success = MagicMock()
+
+    future = Future()
+    post_data_to_handler_async.return_value = future
+    buffer.SendParseRequest( { 'tag_files': [ 'tags' ] },
+                             on_success = on_success )
+    # The request is in progress so this one isn't sent and its data must not be
+    # considered received by the server.
+    in_progress_on_success = MagicMock()
+    buffer.SendParseRequest( { 'tag_files': [ 'other_tags' ] },
+                             on_success = in_progress_on_success )
+    assert_that( post_data_to_handler_async.call_count, equal_to( 1 ) )
+    on_success.assert_not_called()
+
+    future.set_result( None )
+    on_success.assert_called_once_with()
+    in_progress_on_success.assert_not_called()
+
+    # Failed requests don't call it.
+    on_success.reset_mock()
+    future = Future()
+    post_data_to_handler_async.return_value = future
+    buffer.SendParseRequest( {}, on_success = on_success )
+    future.set_exception( OSError( 'timed out' ) )
+    on_success.assert_not_called()
+
+
+  @patch( 'ycm.vimsupport.VisibleBufferNumbers', return_value = { 1 } )
+  @patch( 'ycm.vimsupport.LoadedBufferNumbers', return_value = set() )
+  @patch( 'ycm.buffer.MAX_HIDDEN_BUFFERS', 2 )
+  @patch( 'ycm.buffer.EVICTION_BATCH_SIZE', 0 )
+  def test_BufferDict_EvictLeastRecentlyUsedHiddenBuffers( self, *args ):
+    buffers = BufferDict( MagicMock() )
+    for bufnr in range( 1, 4 ):
+      buffers[ bufnr ]
+    buffers[ 2 ]
+    assert_that( list( buffers ), contains_exactly( 1, 3, 2 ) )
+
+    # Buffer 3 is the least recently used hidden buffer. Buffer 1 is visible so
+    # it's kept.
+    buffers[ 4 ]
+    assert_that( list( buffers ), contains_exactly( 1, 2, 4 ) )
+
+
+  @patch( 'ycm.vimsupport.VisibleBufferNumbers', return_value = set() )
+  @patch( 'ycm.vimsupport.LoadedBufferNumbers', return_value = set() )
+  @patch( 'ycm.buffer.MAX_HIDDEN_BUFFERS', 2 )
+  @patch( 'ycm.buffer.EVICTION_BATCH_SIZE', 2 )
+  def test_BufferDict_EvictHiddenBuffersByBatches( self,
+                                                  loaded_buffer_numbers,
+                                                  visible_buffer_numbers,
+                                                  *args ):
+    buffers = BufferDict( MagicMock() )
+    for bufnr in range( 1, 5 ):
+      buffers[ bufnr ]
+    visible_buffer_numbers.assert_not_called()
+
+    # The displayed buffers are looked up once per batch.
+    buffers[ 5 ]
+    visible_buffer_numbers.assert_called_once_with()
+    loaded_buffer_numbers.assert_called_once_with( [ 1, 2, 3 ] )
+    assert_that( list( buffers ), contains_exactly( 4, 5 ) )
+
+    buffers[ 6 ]
+    buffers[ 7 ]
+    visible_buffer_numbers.assert_called_once_with()
+
+
+  @patch( 'ycm.vimsupport.VisibleBufferNumbers', return_value = set() )
+  @patch( 'ycm.vimsupport.LoadedBufferNumbers', return_value = { 1 } )
+  @patch( 'ycm.buffer.MAX_HIDDEN_BUFFERS', 1 )
+  @patch( 'ycm.buffer.EVICTION_BATCH_SIZE', 0 )
+  @patch( 'ycm.buffer.Buffer.ClearDiagnosticsUI' )
+  def test_BufferDict_ClearDiagnosticsOfEvictedLoadedBuffers(
+      self, clear_diagnostics_ui, *args ):
+    buffers = BufferDict( MagicMock() )
+    buffers[ 1 ]
+    clear_diagnostics_ui.assert_not_called()
+    buffers[ 2 ]
+    clear_diagnostics_ui.assert_called_once_with()
+    assert_that( list( buffers ), contains_exactly( 2 ) )
@@ -18,10 +18,46 @@
 from ycm.tests.test_utils import MockVimBuffers, MockVimModule, VimBuffer
 MockVimModule()
 
-from hamcrest import assert_that, has_entry
+import io
+import json
+import socket
+import zlib
+from base64 import b64encode, b64decode
+from hamcrest import ( assert_that, calling, close_to, equal_to, has_entry,
+                       has_key, is_not, raises )
 from unittest import TestCase
 from unittest.mock import patch
-from ycm.client.base_request import BuildRequestData
+from concurrent.futures import Future
+from ycm.client.base_request import ( AdaptiveTimeout, BaseRequest,
+                                      BuildRequestData, GetLatencyHistograms,
+                                      GetRoundTripStatistics,
+                                      LatencyHistogram,
+                                      LatencyHistogramsSnapshot,
+                                      ResetLatencyStatistics,
+                                      RoundTripStatistics,
+                                      _DecodeResponse, _EncodeBody,
+                                      _ReadResponse, _RecordAcceptedEncodings,
+                                      _ValidateResponseObject )
+from ycmd.hmac_utils import CreateHmac, CreateRequestHmac
+
+
+class FakeHttpResponse:
+  def __init__( self, body, length, hmac = None, headers = None ):
+    self._body = io.BytesIO( body )
+    self.length = length
+    if hmac is None:
+      hmac = CreateHmac( body, b'secret' )
+    self.headers = { 'x-ycm-hmac': b64encode( hmac ) }
+    if headers is not None:
+      self.headers = headers
+
+
+  def read( self ):
+    return self._body.read()
+
+
+  def readinto( self, buffer ):
+    return self._body.readinto( buffer )
 
 
 class BaseRequestTest( TestCase ):
@@ -40,3 +76,236 @@ class BaseRequestTest( TestCase ):
     with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
       assert_that( BuildRequestData( current_buffer.number ),
                    has_entry( 'working_dir', '/some/dir' ) )
+
+
+  def test_RoundTripStatistics_Record( self ):
+    statistics = RoundTripStatistics()
+    statistics.Record( 10.0, 10.1 )
+    assert_that( statistics.smoothed_seconds, close_to( 0.1, 1e-9 ) )
+    statistics.Record( 11.0, 11.9 )
+    assert_that( statistics.smoothed_seconds, close_to( 0.2, 1e-9 ) )
+    assert_that( statistics.last_response_time, equal_to( 11.9 ) )
+    assert_that( statistics.count, equal_to( 2 ) )
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.hmac_secret', b'secret' )
+  def test_EncodeBody_HmacOfBody( self ):
+    data = { 'file_data': { '/foo': { 'contents': 'bär\n' * 1000 } } }
+    body, content_encoding, body_hmac = _EncodeBody( data )
+    assert_that( body, equal_to( json.dumps( data ).encode( 'utf-8' ) ) )
+    assert_that( content_encoding, equal_to( None ) )
+    assert_that( body_hmac, equal_to( CreateHmac( body, b'secret' ) ) )
+
+    assert_that( _EncodeBody( None ),
+                 equal_to( ( b'', None, CreateHmac( b'', b'secret' ) ) ) )
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.hmac_secret', b'secret' )
+  def test_ExtraHeaders_SameHmacAsServer( self ):
+    body = b'{"filepath": "/foo"}'
+    headers = BaseRequest._ExtraHeaders(
+      'POST', 'http://127.0.0.1:1234/event_notification',
+      CreateHmac( body, b'secret' ) )
+    assert_that( b64decode( headers[ 'x-ycm-hmac' ] ),
+                 equal_to( CreateRequestHmac( b'POST',
+                                              b'/event_notification',
+                                              body,
+                                              b'secret' ) ) )
+
+    headers = BaseRequest._ExtraHeaders( 'GET', 'http://127.0.0.1:1234/ready' )
+    assert_that( b64decode( headers[ 'x-ycm-hmac' ] ),
+                 equal_to( CreateRequestHmac( b'GET', b'/ready', b'',
+                                              b'secret' ) ) )
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.hmac_secret', b'secret' )
+  @patch( 'ycm.client.base_request._RESPONSE_CHUNK_SIZE', 7 )
+  def test_ReadResponse_HmacOfChunks( self ):
+    body = json.dumps( [ 'foo' ] * 100 ).encode( 'utf-8' )
+    for length in [ len( body ), None ]:
+      response = FakeHttpResponse( body, length )
+      response_text, response_hmac = _ReadResponse( response )
+      assert_that( bytes( response_text ), equal_to( body ) )
+      assert_that( response_hmac, equal_to( CreateHmac( body, b'secret' ) ) )
+      _ValidateResponseObject( response, response_text, response_hmac )
+
+    response = FakeHttpResponse( body, len( body ), b'invalid' )
+    response_text, response_hmac = _ReadResponse( response )
+    assert_that( calling( _ValidateResponseObject ).with_args(
+                   response, response_text, response_hmac ),
+                 raises( RuntimeError, 'Received invalid HMAC' ) )
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.hmac_secret', b'secret' )
+  def test_ReadResponse_Truncated( self ):
+    body = b'[ "foo" ]'
+    response = FakeHttpResponse( body, len( body ) + 10 )
+    response_text, response_hmac = _ReadResponse( response )
+    assert_that( bytes( response_text ), equal_to( body ) )
+    assert_that( response_hmac, equal_to( CreateHmac( body, b'secret' ) ) )
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.hmac_secret', b'secret' )
+  def test_EncodeBody_CompressWhenAcceptedAndLargeEnough( self ):
+    data = { 'contents': 'foo\n' * 1000 }
+    json_body = json.dumps( data ).encode( 'utf-8' )
+    with patch.multiple( 'ycm.client.base_request.BaseRequest',
+                         compression_threshold = 4000,
+                         accepted_encodings = frozenset( [ 'deflate' ] ) ):
+      body, content_encoding, body_hmac = _EncodeBody( data )
+      assert_that( content_encoding, equal_to( 'deflate' ) )
+      assert_that( zlib.decompress( body ), equal_to( json_body ) )
+      # The HMAC is the one of the body as sent.
+      assert_that( body_hmac, equal_to( CreateHmac( body, b'secret' ) ) )
+
+    for compression_threshold, accepted_encodings in [
+        ( 10000, frozenset( [ 'deflate' ] ) ),
+        ( 4000, frozenset() ),
+        ( 0, frozenset( [ 'deflate' ] ) ) ]:
+      with patch.multiple( 'ycm.client.base_request.BaseRequest',
+                           compression_threshold = compression_threshold,
+                           accepted_encodings = accepted_encodings ):
+        assert_that( _EncodeBody( data ),
+                     equal_to( ( json_body,
+                                 None,
+                                 CreateHmac( json_body, b'secret' ) ) ) )
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.accepted_encodings',
+          frozenset() )
+  def test_RecordAcceptedEncodings( self ):
+    _RecordAcceptedEncodings( FakeHttpResponse( b'', None, headers = {} ) )
+    assert_that( BaseRequest.accepted_encodings, equal_to( frozenset() ) )
+
+    _RecordAcceptedEncodings( FakeHttpResponse(
+      b'', None, headers = { 'accept-encoding': 'gzip, Deflate;q=0.5' } ) )
+    assert_that( BaseRequest.accepted_encodings,
+                 equal_to( frozenset( [ 'gzip', 'deflate' ] ) ) )
+
+
+  def test_DecodeResponse( self ):
+    body = b'[ "foo" ]'
+    assert_that( _DecodeResponse( FakeHttpResponse( body, None, headers = {} ),
+                                  body ),
+                 equal_to( body ) )
+
+    response = FakeHttpResponse( body, None,
+                                 headers = { 'content-encoding': 'deflate' } )
+    assert_that( _DecodeResponse( response, zlib.compress( body ) ),
+                 equal_to( body ) )
+
+    response = FakeHttpResponse( body, None,
+                                 headers = { 'content-encoding': 'br' } )
+    assert_that( calling( _DecodeResponse ).with_args( response, body ),
+                 raises( RuntimeError, 'unsupported encoding br' ) )
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.hmac_secret', b'secret' )
+  def test_ExtraHeaders_AcceptEncoding( self ):
+    with patch( 'ycm.client.base_request.BaseRequest.compression_threshold',
+                0 ):
+      headers = BaseRequest._ExtraHeaders( 'GET', 'http://127.0.0.1/ready' )
+      assert_that( headers, is_not( has_key( 'accept-encoding' ) ) )
+
+    with patch( 'ycm.client.base_request.BaseRequest.compression_threshold',
+                1024 ):
+      headers = BaseRequest._ExtraHeaders( 'GET', 'http://127.0.0.1/ready' )
+      assert_that( headers, has_entry( 'accept-encoding', 'deflate' ) )
+
+
+  def test_LatencyHistogram_Quantile( self ):
+    histogram = LatencyHistogram()
+    assert_that( histogram.Quantile( 0.5 ), equal_to( None ) )
+    for _ in range( 98 ):
+      histogram.Record( 0.01 )
+    histogram.Record( 0.0001 )
+    histogram.Record( 1000, timed_out = True )
+    assert_that( histogram.count, equal_to( 100 ) )
+    assert_that( histogram.timeouts, equal_to( 1 ) )
+    assert_that( histogram.Quantile( 0 ), equal_to( 0.001 ) )
+    assert_that( histogram.Quantile( 0.5 ), close_to( 0.01, 0.002 ) )
+    assert_that( histogram.Quantile( 0.99 ), close_to( 0.01, 0.002 ) )
+    # Latencies above a minute are all counted in the last bucket.
+    assert_that( histogram.Quantile( 0.999 ), close_to( 55.1, 0.01 ) )
+
+
+  @patch.dict( 'ycm.client.base_request._latency_histograms', clear = True )
+  def test_AdaptiveTimeout( self ):
+    # Handlers that may legitimately take long keep the fixed timeout.
+    GetLatencyHistograms()[ 'event_notification' ].Record( 0.01 )
+    assert_that( AdaptiveTimeout( 'event_notification' ), equal_to( 30 ) )
+
+    # The fixed timeout is used until enough latencies are known.
+    assert_that( AdaptiveTimeout( 'completions' ), equal_to( 30 ) )
+    assert_that( AdaptiveTimeout( 'semantic_tokens' ), equal_to( 30 ) )
+    histogram = GetLatencyHistograms()[ 'semantic_tokens' ]
+    for _ in range( 99 ):
+      histogram.Record( 0.1 )
+    assert_that( AdaptiveTimeout( 'semantic_tokens' ), equal_to( 30 ) )
+
+    histogram.Record( 0.1 )
+    assert_that( AdaptiveTimeout( 'semantic_tokens' ), equal_to( 2 ) )
+
+    histogram.Record( 1 )
+    assert_that( AdaptiveTimeout( 'semantic_tokens' ), close_to( 4, 0.8 ) )
+
+    histogram.Record( 30 )
+    assert_that( AdaptiveTimeout( 'semantic_tokens' ), equal_to( 20 ) )
+
+
+  @patch.dict( 'ycm.client.base_request._latency_histograms', clear = True )
+  def test_LatencyHistogramsSnapshot( self ):
+    assert_that( LatencyHistogramsSnapshot(), equal_to( [] ) )
+
+    GetLatencyHistograms()[ 'semantic_tokens' ].Record( 0.1 )
+    GetLatencyHistograms()[ 'completions' ].Record( 0.01 )
+    snapshot = LatencyHistogramsSnapshot()
+    assert_that( [ handler for handler, _ in snapshot ],
+                 equal_to( [ 'completions', 'semantic_tokens' ] ) )
+
+    # The snapshot is not updated by later requests.
+    GetLatencyHistograms()[ 'completions' ].Record( 0.01 )
+    assert_that( snapshot[ 0 ][ 1 ].count, equal_to( 1 ) )
+    assert_that( snapshot[ 0 ][ 1 ].Quantile( 1 ), close_to( 0.01, 0.003 ) )
+
+
+  @patch.dict( 'ycm.client.base_request._latency_histograms', clear = True )
+  @patch( 'ycm.client.base_request._round_trip_statistics',
+          RoundTripStatistics() )
+  def test_ResetLatencyStatistics( self ):
+    GetLatencyHistograms()[ 'completions' ].Record( 0.01 )
+    GetRoundTripStatistics().Record( 1, 1.01 )
+
+    ResetLatencyStatistics()
+    assert_that( LatencyHistogramsSnapshot(), equal_to( [] ) )
+    assert_that( GetRoundTripStatistics().count, equal_to( 0 ) )
+    assert_that( GetRoundTripStatistics().last_response_time, equal_to( None ) )
+
+
+  @patch( 'ycm.client.base_request.DisplayServerException' )
+  def test_HandleFuture_TimeoutNotDisplayed( self, display_server_exception ):
+    future = Future()
+    future.set_exception( socket.timeout( 'timed out' ) )
+    assert_that( BaseRequest().HandleFuture( future ), equal_to( None ) )
+    display_server_exception.assert_not_called()
+
+
+  @patch( 'ycm.client.base_request.BaseRequest.hmac_secret', b'secret' )
+  @patch.dict( 'ycm.client.base_request._latency_histograms', clear = True )
+  def test_TalkToHandlerAsync_RecordTimeout( self ):
+    # The server accepts the connection but never answers.
+    with socket.socket() as server:
+      server.bind( ( '127.0.0.1', 0 ) )
+      server.listen()
+      port = server.getsockname()[ 1 ]
+      with patch( 'ycm.client.base_request.BaseRequest.server_location',
+                  f'http://127.0.0.1:{ port }' ):
+        future = BaseRequest.PostDataToHandlerAsync( { 'foo': 'bar' },
+                                                     'completions',
+                                                     timeout = 0.05 )
+        assert_that( calling( future.result ), raises( OSError ) )
+
+    histogram = GetLatencyHistograms()[ 'completions' ]
+    assert_that( histogram.count, equal_to( 1 ) )
+    assert_that( histogram.timeouts, equal_to( 1 ) )
+    assert_that( histogram.Quantile( 1 ), close_to( 0.05, 0.05 ) )
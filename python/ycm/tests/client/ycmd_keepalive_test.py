@@ -0,0 +1,78 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+from hamcrest import assert_that, close_to
+from unittest import TestCase
+from unittest.mock import patch
+from ycm.client.base_request import RoundTripStatistics
+from ycm.client.ycmd_keepalive import YcmdKeepalive
+
+
+class YcmdKeepaliveTest( TestCase ):
+  @patch( 'ycm.client.ycmd_keepalive.time.monotonic', return_value = 100 )
+  def test_SecondsUntilNextPing_NoRequest( self, *args ):
+    with patch( 'ycm.client.ycmd_keepalive.GetRoundTripStatistics',
+                return_value = RoundTripStatistics() ):
+      keepalive = YcmdKeepalive( ping_interval_seconds = 60 )
+      assert_that( keepalive._SecondsUntilNextPing(), close_to( 60, 1e-9 ) )
+
+
+  @patch( 'ycm.client.ycmd_keepalive.time.monotonic', return_value = 100 )
+  def test_SecondsUntilNextPing_RecentRequest( self, monotonic ):
+    statistics = RoundTripStatistics()
+    with patch( 'ycm.client.ycmd_keepalive.GetRoundTripStatistics',
+                return_value = statistics ):
+      keepalive = YcmdKeepalive( ping_interval_seconds = 60 )
+      statistics.Record( 129.9, 130 )
+      monotonic.return_value = 150
+      assert_that( keepalive._SecondsUntilNextPing(), close_to( 40, 1e-9 ) )
+
+      # No request for a whole interval.
+      monotonic.return_value = 190
+      assert_that( keepalive._SecondsUntilNextPing(), close_to( 0, 1e-9 ) )
+
+
+  @patch( 'ycm.client.ycmd_keepalive.time.monotonic', return_value = 100 )
+  def test_SecondsUntilNextStandbyPing( self, monotonic ):
+    statistics = RoundTripStatistics()
+    with patch( 'ycm.client.ycmd_keepalive.GetRoundTripStatistics',
+                return_value = statistics ):
+      keepalive = YcmdKeepalive( ping_interval_seconds = 60 )
+      # Requests to the current server don't keep the standby server alive.
+      statistics.Record( 129.9, 130 )
+      monotonic.return_value = 150
+      assert_that( keepalive._SecondsUntilNextStandbyPing(),
+                   close_to( 10, 1e-9 ) )
+
+
+  @patch( 'ycm.client.ycmd_keepalive.PingServer' )
+  def test_PingStandbyServer( self, ping_server ):
+    keepalive = YcmdKeepalive()
+    keepalive._PingStandbyServer()
+    ping_server.assert_not_called()
+
+    keepalive.SetStandbyServer( 'http://127.0.0.1:1234', b'secret' )
+    keepalive._PingStandbyServer()
+    ping_server.assert_called_once_with( 'http://127.0.0.1:1234', b'secret' )
+
+    ping_server.reset_mock()
+    keepalive.SetStandbyServer( None, None )
+    keepalive._PingStandbyServer()
+    ping_server.assert_not_called()
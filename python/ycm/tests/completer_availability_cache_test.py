@@ -0,0 +1,95 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+import os
+import tempfile
+from hamcrest import assert_that, equal_to
+from unittest import TestCase
+from unittest.mock import patch
+from ycm.completer_availability_cache import CompleterAvailabilityCache
+
+OPTIONS = { 'filepath_completion_use_working_dir': 0 }
+
+
+class CompleterAvailabilityCacheTest( TestCase ):
+  def setUp( self ):
+    self._temp_dir = tempfile.TemporaryDirectory()
+    self.addCleanup( self._temp_dir.cleanup )
+    self._ycmd_dir = os.path.join( self._temp_dir.name, 'ycmd' )
+    os.makedirs( os.path.join( self._ycmd_dir, 'third_party' ) )
+    self._build_file = os.path.join( self._ycmd_dir,
+                                     'PYTHON_USED_DURING_BUILDING' )
+    with open( self._build_file, 'w' ) as build_file:
+      build_file.write( 'python3' )
+
+    for patcher in [
+      patch( 'ycm.paths.DIR_OF_YCMD', self._ycmd_dir ),
+      patch( 'ycm.completer_availability_cache._CacheFile',
+             return_value = os.path.join( self._temp_dir.name, 'cache.json' ) )
+    ]:
+      patcher.start()
+      self.addCleanup( patcher.stop )
+
+
+  def test_CompleterAvailabilityCache_LoadFromDisk( self ):
+    cache = CompleterAvailabilityCache( OPTIONS )
+    assert_that( cache.Get( 'cpp' ), equal_to( None ) )
+    cache.Set( 'cpp', True )
+    cache.Set( 'text', False )
+
+    cache = CompleterAvailabilityCache( OPTIONS )
+    assert_that( cache.Get( 'cpp' ), equal_to( True ) )
+    assert_that( cache.Get( 'text' ), equal_to( False ) )
+
+
+  def test_CompleterAvailabilityCache_MergeOtherInstances( self ):
+    cache = CompleterAvailabilityCache( OPTIONS )
+    other_cache = CompleterAvailabilityCache( OPTIONS )
+    assert_that( other_cache.Get( 'cpp' ), equal_to( None ) )
+    cache.Set( 'cpp', True )
+    other_cache.Set( 'python', True )
+
+    cache = CompleterAvailabilityCache( OPTIONS )
+    assert_that( cache.Get( 'cpp' ), equal_to( True ) )
+    assert_that( cache.Get( 'python' ), equal_to( True ) )
+
+
+  def test_CompleterAvailabilityCache_OptionsChanged( self ):
+    CompleterAvailabilityCache( OPTIONS ).Set( 'cpp', True )
+    cache = CompleterAvailabilityCache(
+      { 'filepath_completion_use_working_dir': 1 } )
+    assert_that( cache.Get( 'cpp' ), equal_to( None ) )
+
+
+  def test_CompleterAvailabilityCache_Rebuilt( self ):
+    CompleterAvailabilityCache( OPTIONS ).Set( 'cpp', True )
+    stat = os.stat( self._build_file )
+    os.utime( self._build_file,
+              ns = ( stat.st_atime_ns, stat.st_mtime_ns + 1000000000 ) )
+    assert_that( CompleterAvailabilityCache( OPTIONS ).Get( 'cpp' ),
+                 equal_to( None ) )
+
+
+  def test_CompleterAvailabilityCache_NotBuilt( self ):
+    os.remove( self._build_file )
+    CompleterAvailabilityCache( OPTIONS ).Set( 'cpp', True )
+    assert_that( CompleterAvailabilityCache( OPTIONS ).Get( 'cpp' ),
+                 equal_to( None ) )
+    assert_that( os.listdir( self._temp_dir.name ), equal_to( [ 'ycmd' ] ) )
@@ -22,6 +22,7 @@ from hamcrest import ( assert_that,
                        has_entries,
                        has_item )
 from unittest import TestCase
+from unittest.mock import MagicMock, patch
 MockVimModule()
 
 
@@ -179,6 +180,37 @@ class DiagnosticInterfaceTest( TestCase ):
           assert_that( actual, result )
 
 
+  def test_DisplayedLinesAndDiagnostics_LargeFile( self ):
+    current_buffer = VimBuffer( 'foo', number = 1, contents = [ '' ] * 100 )
+    with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
+      diag_interface = diagnostic_interface.DiagnosticInterface( 1,
+                                                                 MagicMock() )
+      diags = [ SimpleDiagnosticToJson( line, 1, line, 1 )
+                for line in [ 1, 50, 99 ] ]
+      for diag in diags:
+        diag[ 'location_extent' ][ 'start' ][ 'filepath' ] = 'foo'
+      with patch( 'ycm.vimsupport.GetBufferNumberForFilename',
+                  return_value = 1 ):
+        diag_interface._diagnostics = diags
+        diag_interface._ConvertDiagListToDict()
+
+      assert_that( [ line for line, _ in
+                     diag_interface._DisplayedLinesAndDiagnostics() ],
+                   contains_exactly( 1, 50, 99 ) )
+
+      with patch( 'ycm.vimsupport.IsLargeFile', return_value = True ):
+        with patch( 'ycm.vimsupport.RangeVisibleInBuffer', return_value = {
+          'start': { 'line_num': 40 }, 'end': { 'line_num': 60 } } ):
+          assert_that( [ line for line, _ in
+                         diag_interface._DisplayedLinesAndDiagnostics() ],
+                       contains_exactly( 50 ) )
+
+        with patch( 'ycm.vimsupport.RangeVisibleInBuffer',
+                    return_value = None ):
+          assert_that( diag_interface._DisplayedLinesAndDiagnostics(),
+                       equal_to( [] ) )
+
+
   def test_IsValidRange( self ):
     for start_line, start_col, end_line, end_col, expect in (
       ( 1, 1, 1, 1, True ),
@@ -22,6 +22,8 @@ MockVimModule()
 
 import contextlib
 import os
+import tempfile
+from concurrent.futures import Future
 
 from ycm.tests import ( PathToTestFile, test_utils, YouCompleteMeInstance,
                         WaitUntilReady )
@@ -41,6 +43,17 @@ def PresentDialog_Confirm_Call( message ):
   return call( message, [ 'Ok', 'Cancel' ] )
 
 
+def CompletedFuture( exception = None ):
+  """Return a future for a request that the server answered or, if
+  |exception| is given, that failed with it."""
+  future = Future()
+  if exception:
+    future.set_exception( exception )
+  else:
+    future.set_result( None )
+  return future
+
+
 @contextlib.contextmanager
 def MockArbitraryBuffer( filetype ):
   """Used via the with statement, set up a single buffer with an arbitrary name
@@ -413,6 +426,57 @@ class EventNotificationTest( TestCase ):
       )
 
 
+  @patch( 'ycm.youcompleteme.YouCompleteMe._AddUltiSnipsDataIfNeeded' )
+  @YouCompleteMeInstance( { 'g:ycm_collect_identifiers_from_tags_files': 1 } )
+  def test_EventNotification_FileReadyToParse_TagFiles_OnlySendChanged(
+      self, ycm, *args ):
+    current_buffer = VimBuffer( name = 'current_buffer',
+                                filetype = 'some_filetype' )
+
+    with tempfile.TemporaryDirectory() as tags_dir:
+      tag_file = os.path.join( os.path.realpath( tags_dir ), 'tags' )
+      with open( tag_file, 'w' ) as tags:
+        tags.write( 'foo\tfoo.c\t1\n' )
+
+      with patch( 'ycm.client.event_notification.EventNotification.'
+                  'PostDataToHandlerAsync' ) as post_data_to_handler_async:
+        post_data_to_handler_async.return_value = CompletedFuture()
+        with CurrentWorkingDirectory( tags_dir ):
+          with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
+            ycm.OnFileReadyToParse()
+            assert_that(
+              # Positional arguments passed to PostDataToHandlerAsync.
+              post_data_to_handler_async.call_args[ 0 ],
+              contains_exactly(
+                has_entry( 'tag_files', contains_exactly( tag_file ) ),
+                'event_notification'
+              )
+            )
+
+            # Do not send the tag file again if it didn't change.
+            ycm.OnFileReadyToParse()
+            assert_that(
+              # Positional arguments passed to PostDataToHandlerAsync.
+              post_data_to_handler_async.call_args[ 0 ],
+              contains_exactly(
+                is_not( has_key( 'tag_files' ) ),
+                'event_notification'
+              )
+            )
+
+            with open( tag_file, 'a' ) as tags:
+              tags.write( 'bar\tbar.c\t1\n' )
+            ycm.OnFileReadyToParse()
+            assert_that(
+              # Positional arguments passed to PostDataToHandlerAsync.
+              post_data_to_handler_async.call_args[ 0 ],
+              contains_exactly(
+                has_entry( 'tag_files', contains_exactly( tag_file ) ),
+                'event_notification'
+              )
+            )
+
+
   @patch( 'ycm.youcompleteme.YouCompleteMe._AddUltiSnipsDataIfNeeded' )
   @YouCompleteMeInstance()
   def test_EventNotification_BufferVisit_BuildRequestForCurrentAndUnsavedBuffers( # noqa
@@ -532,6 +596,7 @@ fooGroup xxx foo bar
 
     with patch( 'ycm.client.event_notification.EventNotification.'
                 'PostDataToHandlerAsync' ) as post_data_to_handler_async:
+      post_data_to_handler_async.return_value = CompletedFuture()
       with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
         ycm.OnFileReadyToParse()
         assert_that(
@@ -555,6 +620,103 @@ fooGroup xxx foo bar
         )
 
 
+  @patch( 'ycm.vimsupport.CaptureVimCommand', return_value = """
+fooGroup xxx foo bar
+             links to Statement""" )
+  @YouCompleteMeInstance( { 'g:ycm_seed_identifiers_with_syntax': 1 } )
+  def test_EventNotification_FileReadyToParse_SyntaxKeywords_SendUntilReceived( # noqa
+      self, ycm, *args ):
+
+    current_buffer = VimBuffer( name = 'current_buffer',
+                                filetype = 'some_filetype' )
+
+    with patch( 'ycm.client.event_notification.EventNotification.'
+                'PostDataToHandlerAsync' ) as post_data_to_handler_async:
+      in_progress_future = Future()
+      post_data_to_handler_async.return_value = in_progress_future
+      with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
+        ycm.OnFileReadyToParse()
+        assert_that(
+          # Positional arguments passed to PostDataToHandlerAsync.
+          post_data_to_handler_async.call_args[ 0 ],
+          contains_exactly(
+            has_entry( 'syntax_keywords', has_items( 'foo', 'bar' ) ),
+            'event_notification'
+          )
+        )
+
+        # A parse is already in progress so no request is sent.
+        ycm.OnFileReadyToParse()
+        assert_that( post_data_to_handler_async.call_count, equal_to( 1 ) )
+
+        # The request failed so the keywords are sent again.
+        in_progress_future.set_exception( OSError( 'timed out' ) )
+        post_data_to_handler_async.return_value = CompletedFuture()
+        ycm.OnFileReadyToParse()
+        assert_that(
+          # Positional arguments passed to PostDataToHandlerAsync.
+          post_data_to_handler_async.call_args[ 0 ],
+          contains_exactly(
+            has_entry( 'syntax_keywords', has_items( 'foo', 'bar' ) ),
+            'event_notification'
+          )
+        )
+
+        # Until the server received them.
+        ycm.OnFileReadyToParse()
+        assert_that(
+          # Positional arguments passed to PostDataToHandlerAsync.
+          post_data_to_handler_async.call_args[ 0 ],
+          contains_exactly(
+            is_not( has_key( 'syntax_keywords' ) ),
+            'event_notification'
+          )
+        )
+
+
+  @patch( 'ycm.vimsupport.CaptureVimCommand', return_value = """
+fooGroup xxx foo bar
+             links to Statement""" )
+  @YouCompleteMeInstance( { 'g:ycm_seed_identifiers_with_syntax': 1 } )
+  def test_EventNotification_FileReadyToParse_SyntaxKeywords_SendIfChanged(
+      self, ycm, capture_vim_command ):
+
+    current_buffer = VimBuffer( name = 'current_buffer',
+                                filetype = 'some_filetype' )
+
+    with patch( 'ycm.client.event_notification.EventNotification.'
+                'PostDataToHandlerAsync' ) as post_data_to_handler_async:
+      post_data_to_handler_async.return_value = CompletedFuture()
+      with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
+        ycm.OnFileReadyToParse()
+
+        # Do not send the same keywords again when the syntax is reloaded.
+        ycm.OnSyntaxSet( 'some_filetype' )
+        ycm.OnFileReadyToParse()
+        assert_that(
+          # Positional arguments passed to PostDataToHandlerAsync.
+          post_data_to_handler_async.call_args[ 0 ],
+          contains_exactly(
+            is_not( has_key( 'syntax_keywords' ) ),
+            'event_notification'
+          )
+        )
+
+        capture_vim_command.return_value = """
+fooGroup xxx foo bar baz
+             links to Statement"""
+        ycm.OnSyntaxSet( 'some_filetype' )
+        ycm.OnFileReadyToParse()
+        assert_that(
+          # Positional arguments passed to PostDataToHandlerAsync.
+          post_data_to_handler_async.call_args[ 0 ],
+          contains_exactly(
+            has_entry( 'syntax_keywords', has_items( 'foo', 'bar', 'baz' ) ),
+            'event_notification'
+          )
+        )
+
+
   @patch( 'ycm.vimsupport.CaptureVimCommand', return_value = """
 fooGroup xxx foo bar
              links to Statement""" )
@@ -567,6 +729,7 @@ fooGroup xxx foo bar
 
     with patch( 'ycm.client.event_notification.EventNotification.'
                 'PostDataToHandlerAsync' ) as post_data_to_handler_async:
+      post_data_to_handler_async.return_value = CompletedFuture()
       with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
         ycm.OnFileReadyToParse()
         assert_that(
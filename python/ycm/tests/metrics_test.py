@@ -0,0 +1,85 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+from hamcrest import assert_that, equal_to
+from types import SimpleNamespace
+from unittest import TestCase
+from unittest.mock import MagicMock, patch
+from ycm import metrics, vimsupport
+
+
+@patch.dict( 'ycm.metrics._counters', clear = True )
+@patch.dict( 'ycm.metrics._gauges', clear = True )
+class MetricsTest( TestCase ):
+  def test_Snapshot( self ):
+    metrics.Increment( 'requests', 'completions' )
+    metrics.Increment( 'requests', 'completions' )
+    metrics.Increment( 'bytes', 'sent', 1024 )
+    metrics.RecordCacheLookup( 'buffer_data', True )
+    metrics.RecordCacheLookup( 'buffer_data', True )
+    metrics.RecordCacheLookup( 'buffer_data', False )
+    metrics.RecordCacheLookup( 'buffer_data', True )
+    metrics.AddToGauge( 'requests_in_flight', 1 )
+    metrics.AddToGauge( 'requests_in_flight', 1 )
+    metrics.AddToGauge( 'requests_in_flight', -1 )
+
+    assert_that( metrics.Snapshot(), equal_to( {
+      'requests': { 'completions': 2 },
+      'bytes': { 'sent': 1024 },
+      'cache_hits': { 'buffer_data': 3 },
+      'cache_misses': { 'buffer_data': 1 },
+      'cache_hit_rates': { 'buffer_data': 0.75 },
+      'gauges': { 'requests_in_flight': 1, 'requests_in_flight_max': 2 }
+    } ) )
+
+
+  def test_FormatReport( self ):
+    assert_that( metrics.FormatReport( {} ),
+                 equal_to( 'No statistics recorded.' ) )
+    assert_that( metrics.FormatReport( {
+      'requests': { 'completions': 2, 'event_notification': 1 },
+      'cache_hit_rates': { 'buffer_data': 0.75 },
+      'request_latencies': { 'completions': { 'count': 2, 'p50_ms': 1.5 } }
+    } ), equal_to(
+      'cache_hit_rates:\n'
+      '  buffer_data: 0.750\n'
+      'request_latencies:\n'
+      '  completions: count 2, p50_ms 1.500\n'
+      'requests:\n'
+      '  completions: 2\n'
+      '  event_notification: 1' ) )
+
+
+  def test_InstrumentVimBridge( self ):
+    vim_module = SimpleNamespace( eval = MagicMock( return_value = '1' ),
+                                  command = MagicMock() )
+    metrics.InstrumentVimBridge( vim_module )
+    metrics.InstrumentVimBridge( vim_module )
+
+    with patch( 'ycm.vimsupport.vim', vim_module ):
+      # Calls made through vimsupport are counted for its caller.
+      assert_that( vimsupport.GetIntValue( 'x' ), equal_to( 1 ) )
+      vim_module.eval( 'y' )
+      vim_module.command( 'redraw' )
+
+    assert_that( metrics.Snapshot(), equal_to( {
+      'vim_eval_calls': { 'tests.metrics_test': 2 },
+      'vim_command_calls': { 'tests.metrics_test': 1 }
+    } ) )
@@ -27,6 +27,7 @@ class FakeResponse:
     self._json = response
     self._exception = exception
     self.code = HTTP_OK
+    self.headers = {}
 
 
   def read( self ):
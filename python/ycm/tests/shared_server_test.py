@@ -0,0 +1,202 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+import json
+import os
+import tempfile
+from hamcrest import assert_that, calling, equal_to, has_entries, none, raises
+from unittest import TestCase, skipIf
+from unittest.mock import patch
+from ycm import shared_server
+from ycm.shared_server import StateDirectory
+from ycmd.utils import OnWindows
+
+
+@skipIf( OnWindows(), 'Shared server is not supported on Windows' )
+class SharedServerTest( TestCase ):
+  def setUp( self ):
+    self._state_dir = tempfile.TemporaryDirectory()
+    patcher = patch( 'ycm.shared_server.StateDirectory',
+                     return_value = self._state_dir.name )
+    patcher.start()
+    self.addCleanup( patcher.stop )
+    self.addCleanup( self._state_dir.cleanup )
+
+
+  def test_ReadServerState_NoState( self ):
+    assert_that( shared_server.ReadServerState(), none() )
+
+
+  def test_ReadServerState_PublishedState( self ):
+    with shared_server.StateLock():
+      shared_server.PublishServerState( 'http://127.0.0.1:1234',
+                                        b'secret',
+                                        os.getpid(),
+                                        [ 'stdout', 'stderr' ] )
+
+    assert_that( shared_server.ReadServerState(), has_entries( {
+      'server_location': 'http://127.0.0.1:1234',
+      'hmac_secret': b'secret',
+      'pid': os.getpid(),
+      'logfiles': [ 'stdout', 'stderr' ]
+    } ) )
+
+    state_file = os.path.join( self._state_dir.name,
+                               shared_server.STATE_FILENAME )
+    assert_that( os.stat( state_file ).st_mode & 0o777, equal_to( 0o600 ) )
+
+
+  @patch( 'ycm.shared_server.ProcessIsAlive', return_value = False )
+  def test_ReadServerState_ServerIsGone( self, *args ):
+    shared_server.PublishServerState( 'http://127.0.0.1:1234',
+                                      b'secret',
+                                      123456,
+                                      [ 'stdout', 'stderr' ] )
+
+    assert_that( shared_server.ReadServerState(), none() )
+    assert_that( os.path.exists( os.path.join( self._state_dir.name,
+                                               shared_server.STATE_FILENAME ) ),
+                 equal_to( False ) )
+
+
+  def test_UnregisterClient_LastClient( self ):
+    shared_server.RegisterClient()
+    assert_that( shared_server.UnregisterClient(), equal_to( 0 ) )
+
+
+  def test_UnregisterClient_OtherClients( self ):
+    shared_server.RegisterClient()
+    clients_dir = os.path.join( self._state_dir.name,
+                                shared_server.CLIENTS_DIRNAME )
+    # The parent process (the test runner) is alive while a dead client is not.
+    for pid in [ os.getppid(), 999999999 ]:
+      with open( os.path.join( clients_dir, str( pid ) ), 'w' ):
+        pass
+
+    assert_that( shared_server.UnregisterClient(), equal_to( 1 ) )
+    assert_that( os.listdir( clients_dir ),
+                 equal_to( [ str( os.getppid() ) ] ) )
+
+
+  def test_PublishServerState_OtherStateDirectory( self ):
+    # As done by the benchmarks for the Vim instances they start.
+    with tempfile.TemporaryDirectory() as runtime_dir:
+      shared_server.PublishServerState(
+        'http://127.0.0.1:1234',
+        b'secret',
+        os.getpid(),
+        [ 'stdout', 'stderr' ],
+        state_dir = os.path.join( runtime_dir, shared_server.STATE_DIRNAME ) )
+
+      assert_that( shared_server.ReadServerState(), none() )
+      with patch.dict( os.environ, { 'XDG_RUNTIME_DIR': runtime_dir } ):
+        with patch( 'ycm.shared_server.StateDirectory', StateDirectory ):
+          assert_that( shared_server.ReadServerState(), has_entries( {
+            'server_location': 'http://127.0.0.1:1234',
+            'hmac_secret': b'secret'
+          } ) )
+
+
+  def test_StateDirectory( self ):
+    with tempfile.TemporaryDirectory() as runtime_dir:
+      with patch.dict( os.environ, { 'XDG_RUNTIME_DIR': runtime_dir } ):
+        assert_that( StateDirectory(),
+                     equal_to( os.path.join( runtime_dir,
+                                             'ycm_shared_server' ) ) )
+
+    with patch.dict( os.environ, { 'XDG_RUNTIME_DIR': '' } ):
+      assert_that( StateDirectory(),
+                   equal_to( os.path.join(
+                     tempfile.gettempdir(),
+                     f'ycm_shared_server_{ os.getuid() }' ) ) )
+
+
+  def test_PrepareStateDirectory_Private( self ):
+    assert_that( shared_server.PrepareStateDirectory(), equal_to( True ) )
+
+
+  def test_PrepareStateDirectory_OwnedByAnotherUser( self ):
+    with patch( 'ycm.shared_server.os.getuid', return_value = os.getuid() + 1 ):
+      assert_that( shared_server.PrepareStateDirectory(), equal_to( False ) )
+      assert_that( calling( shared_server.RegisterClient ),
+                   raises( shared_server.UnsafeStateDirectory ) )
+
+    # A state planted by the other user is ignored.
+    shared_server.PublishServerState( 'http://127.0.0.1:1234', b'secret',
+                                      os.getpid(), [] )
+    with patch( 'ycm.shared_server.os.getuid', return_value = os.getuid() + 1 ):
+      assert_that( shared_server.ReadServerState(), none() )
+
+
+  def test_PrepareStateDirectory_AccessibleToOtherUsers( self ):
+    os.chmod( self._state_dir.name, 0o777 )
+    assert_that( shared_server.PrepareStateDirectory(), equal_to( False ) )
+    with self.assertRaises( shared_server.UnsafeStateDirectory ):
+      with shared_server.StateLock():
+        pass
+
+
+  def test_PrepareStateDirectory_Symlink( self ):
+    with tempfile.TemporaryDirectory() as other_dir:
+      state_dir = os.path.join( self._state_dir.name, 'link' )
+      os.symlink( other_dir, state_dir )
+      with patch( 'ycm.shared_server.StateDirectory',
+                  return_value = state_dir ):
+        assert_that( shared_server.PrepareStateDirectory(), equal_to( False ) )
+
+
+  def test_PublishServerState_PlantedSymlink( self ):
+    with tempfile.TemporaryDirectory() as other_dir:
+      victim_file = os.path.join( other_dir, 'victim' )
+      with open( victim_file, 'w' ) as f:
+        f.write( 'precious' )
+      os.symlink( victim_file,
+                  os.path.join( self._state_dir.name,
+                                f'{ shared_server.STATE_FILENAME }.'
+                                f'{ os.getpid() }' ) )
+
+      shared_server.PublishServerState( 'http://127.0.0.1:1234', b'secret',
+                                        os.getpid(), [] )
+
+      with open( victim_file ) as f:
+        assert_that( f.read(), equal_to( 'precious' ) )
+    assert_that( shared_server.ReadServerState(),
+                 has_entries( { 'hmac_secret': b'secret' } ) )
+
+
+  def test_ReadServerState_SymlinkedState( self ):
+    with tempfile.TemporaryDirectory() as other_dir:
+      state_file = os.path.join( other_dir, 'server.json' )
+      with open( state_file, 'w' ) as f:
+        json.dump( { 'server_location': 'http://127.0.0.1:1234',
+                     'hmac_secret': 'c2VjcmV0',
+                     'pid': os.getpid(),
+                     'logfiles': [] }, f )
+      os.symlink( state_file, os.path.join( self._state_dir.name,
+                                            shared_server.STATE_FILENAME ) )
+      assert_that( shared_server.ReadServerState(), none() )
+
+
+  def test_ProcessIsAlive( self ):
+    assert_that( shared_server.ProcessIsAlive( os.getpid() ), equal_to( True ) )
+    assert_that( shared_server.ProcessIsAlive( 999999999 ), equal_to( False ) )
+    # A process of another user is not a server or a client we started.
+    with patch( 'ycm.shared_server.os.kill', side_effect = PermissionError ):
+      assert_that( shared_server.ProcessIsAlive( 1 ), equal_to( False ) )
@@ -16,7 +16,8 @@
 # along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
 
 from hamcrest import ( assert_that,
-                       empty )
+                       empty,
+                       equal_to )
 from unittest import TestCase
 from ycm import signature_help as sh
 
@@ -36,3 +37,15 @@ class SignatureHelpTest( TestCase ):
     assert_that( sh._MakeSignatureHelpBuffer( {
       'signatures': []
     } ), empty() )
+
+
+  def test_ArgumentIndex( self ):
+    assert_that( sh.ArgumentIndex( b'' ), equal_to( 0 ) )
+    assert_that( sh.ArgumentIndex( b'first' ), equal_to( 0 ) )
+    assert_that( sh.ArgumentIndex( b'first, sec' ), equal_to( 1 ) )
+    assert_that( sh.ArgumentIndex( b'a, b, c' ), equal_to( 2 ) )
+    assert_that( sh.ArgumentIndex( b'a, f( b' ), equal_to( None ) )
+    assert_that( sh.ArgumentIndex( b'a, "b, c' ), equal_to( None ) )
+    assert_that( sh.ArgumentIndex( b"a, 'b'" ), equal_to( None ) )
+    assert_that( sh.ArgumentIndex( b'a, std::vector<int' ), equal_to( None ) )
+    assert_that( sh.ArgumentIndex( b'a, b[ 0' ), equal_to( None ) )
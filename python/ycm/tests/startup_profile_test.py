@@ -0,0 +1,50 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule
+MockVimModule()
+
+from hamcrest import assert_that, equal_to
+from unittest import TestCase
+from unittest.mock import patch
+from ycm import startup_profile
+
+
+@patch.dict( 'ycm.startup_profile._PHASES', clear = True )
+class StartupProfileTest( TestCase ):
+  def test_FormatReport_NoMeasurements( self ):
+    assert_that( startup_profile.FormatReport(),
+                 equal_to( 'No startup measurements recorded.' ) )
+
+
+  def test_FormatReport_OnlyFirstOccurrenceIsRecorded( self ):
+    startup_profile.RecordSeconds( 'Python imports', 0.0123 )
+    startup_profile.RecordSeconds( 'Server spawn', '0.004' )
+    startup_profile.RecordSeconds( 'Python imports', 1 )
+
+    assert_that( startup_profile.FormatReport(), equal_to(
+      'Python imports     12.3 ms\n'
+      'Server spawn        4.0 ms' ) )
+
+
+  @patch( 'ycm.startup_profile.Now', side_effect = [ 1.0, 1.5 ] )
+  def test_Measure( self, *args ):
+    with startup_profile.Measure( 'Options loading' ):
+      pass
+
+    assert_that( startup_profile.FormatReport(),
+                 equal_to( 'Options loading    500.0 ms' ) )
@@ -0,0 +1,140 @@
+# Copyright (C) 2026 YouCompleteMe contributors
+#
+# This file is part of YouCompleteMe.
+#
+# YouCompleteMe is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# YouCompleteMe is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with YouCompleteMe.  If not, see <http://www.gnu.org/licenses/>.
+
+from ycm.tests.test_utils import MockVimModule, Version
+MockVimModule()
+
+import os
+import tempfile
+from hamcrest import assert_that, equal_to
+from unittest import TestCase
+from unittest.mock import patch
+from ycm import syntax_keywords_cache
+
+SYNTAX_LIST_OUTPUT = """
+fooGroup xxx foo bar
+             links to Statement"""
+
+
+@patch( 'ycm.tests.test_utils.VIM_VERSION', Version( 9, 0, 0 ) )
+class SyntaxKeywordsCacheTest( TestCase ):
+  def setUp( self ):
+    self._cache_dir = tempfile.TemporaryDirectory()
+    self.addCleanup( self._cache_dir.cleanup )
+    self._syntax_file = os.path.join( self._cache_dir.name, 'foo.vim' )
+    with open( self._syntax_file, 'w' ) as syntax_file:
+      syntax_file.write( 'runtime! syntax/bar.vim\n'
+                         'syntax keyword fooGroup foo bar' )
+    self._included_syntax_file = os.path.join( self._cache_dir.name,
+                                               'bar.vim' )
+    with open( self._included_syntax_file, 'w' ) as syntax_file:
+      syntax_file.write( 'syntax keyword barGroup baz' )
+    syntax_files = { 'foo': [ self._syntax_file ],
+                     'bar': [ self._included_syntax_file ] }
+
+    for patcher in [
+      patch( 'ycm.syntax_keywords_cache.CacheDirectory',
+             return_value = self._cache_dir.name ),
+      patch( 'ycm.syntax_keywords_cache._SyntaxFiles',
+             side_effect = lambda filetype: syntax_files.get( filetype, [] ) ),
+      patch.dict( 'ycm.syntax_keywords_cache._keywords_for_key', clear = True )
+    ]:
+      patcher.start()
+      self.addCleanup( patcher.stop )
+
+
+  @patch( 'ycm.vimsupport.CaptureVimCommand',
+          return_value = SYNTAX_LIST_OUTPUT )
+  def test_SyntaxKeywordsForCurrentBuffer_LoadFromDisk( self,
+                                                        capture_vim_command ):
+    assert_that( syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' ),
+                 equal_to( { 'foo', 'bar' } ) )
+    capture_vim_command.assert_called_once()
+
+    # Simulate a new session.
+    syntax_keywords_cache._keywords_for_key.clear()
+    capture_vim_command.reset_mock()
+    assert_that( syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' ),
+                 equal_to( { 'foo', 'bar' } ) )
+    capture_vim_command.assert_not_called()
+
+
+  @patch( 'ycm.vimsupport.CaptureVimCommand',
+          return_value = SYNTAX_LIST_OUTPUT )
+  def test_SyntaxKeywordsForCurrentBuffer_SyntaxFileChanged(
+      self, capture_vim_command ):
+    syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' )
+
+    with open( self._syntax_file, 'a' ) as syntax_file:
+      syntax_file.write( ' baz' )
+    capture_vim_command.return_value = SYNTAX_LIST_OUTPUT.replace(
+      'foo bar', 'foo bar baz' )
+    assert_that( syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' ),
+                 equal_to( { 'foo', 'bar', 'baz' } ) )
+    assert_that( capture_vim_command.call_count, equal_to( 2 ) )
+
+
+  @patch( 'ycm.vimsupport.CaptureVimCommand',
+          return_value = SYNTAX_LIST_OUTPUT )
+  def test_SyntaxKeywordsForCurrentBuffer_NoSyntaxFiles(
+      self, capture_vim_command ):
+    with patch( 'ycm.syntax_keywords_cache._SyntaxFiles', return_value = [] ):
+      for _ in range( 2 ):
+        assert_that(
+          syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' ),
+          equal_to( { 'foo', 'bar' } ) )
+    assert_that( capture_vim_command.call_count, equal_to( 2 ) )
+    assert_that( sorted( os.listdir( self._cache_dir.name ) ),
+                 equal_to( [ 'bar.vim', 'foo.vim' ] ) )
+
+
+  @patch( 'ycm.vimsupport.CaptureVimCommand',
+          return_value = SYNTAX_LIST_OUTPUT )
+  def test_SyntaxKeywordsForCurrentBuffer_IncludedSyntaxFileChanged(
+      self, capture_vim_command ):
+    syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' )
+
+    with open( self._included_syntax_file, 'a' ) as syntax_file:
+      syntax_file.write( ' qux' )
+    capture_vim_command.return_value = SYNTAX_LIST_OUTPUT.replace(
+      'foo bar', 'foo bar qux' )
+    assert_that( syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' ),
+                 equal_to( { 'foo', 'bar', 'qux' } ) )
+    assert_that( capture_vim_command.call_count, equal_to( 2 ) )
+
+
+  @patch( 'ycm.vimsupport.CaptureVimCommand',
+          return_value = SYNTAX_LIST_OUTPUT )
+  def test_SyntaxKeywordsForCurrentBuffer_SyntaxVariableChanged(
+      self, capture_vim_command ):
+    syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' )
+
+    # Variables of the included syntax are taken into account too.
+    with patch.dict( 'ycm.tests.test_utils.VIM_OPTIONS',
+                     { 'g:bar_no_baz': 1 } ):
+      capture_vim_command.return_value = SYNTAX_LIST_OUTPUT.replace(
+        'foo bar', 'foo' )
+      assert_that(
+        syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( 'foo' ),
+        equal_to( { 'foo' } ) )
+    assert_that( capture_vim_command.call_count, equal_to( 2 ) )
+
+
+  def test_SyntaxFilesAndFiletypes( self ):
+    assert_that( syntax_keywords_cache._SyntaxFilesAndFiletypes( 'foo' ),
+                 equal_to( ( [ self._syntax_file, self._included_syntax_file ],
+                             [ 'foo', 'bar' ] ) ) )
@@ -20,7 +20,8 @@ from ycm.tests.test_utils import MockVimModule
 MockVimModule()
 
 import os
-from hamcrest import assert_that, contains_inanyorder, has_item, has_items
+from hamcrest import ( assert_that, contains_inanyorder, has_item, has_items,
+                       has_length )
 from unittest import TestCase
 from ycm import syntax_parse
 from ycmd.utils import ReadFile
@@ -238,6 +239,27 @@ sBar xxx qux nc
                                      'na', 'nb', 'nc' ) )
 
 
+  def test_KeywordsFromSyntaxListOutput_CyclicLinks( self ):
+    assert_that( syntax_parse._KeywordsFromSyntaxListOutput( """
+Foo xxx foo bar
+        links to Bar
+Bar xxx zoo goo
+        links to Foo
+        links to Statement""" ),
+                 contains_inanyorder( 'foo', 'bar', 'zoo', 'goo' ) )
+
+
+  def test_KeywordsFromSyntaxListOutput_LongLinkChain( self ):
+    # Deeper than the default recursion limit.
+    depth = 5000
+    syntax_output = '\n'.join(
+      f'group{ i } xxx keyword{ i }\n'
+      f'        links to { f"group{ i + 1 }" if i < depth else "Statement" }'
+      for i in range( depth + 1 ) )
+    assert_that( syntax_parse._KeywordsFromSyntaxListOutput( syntax_output ),
+                 has_length( depth + 1 ) )
+
+
   def test_SyntaxGroupsFromOutput_Basic( self ):
     assert_that( syntax_parse._SyntaxGroupsFromOutput( """
 foogroup xxx foo bar
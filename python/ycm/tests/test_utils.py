@@ -24,6 +24,7 @@ from hamcrest import ( assert_that,
                        equal_to )
 import contextlib
 import functools
+import itertools
 import json
 import os
 import re
@@ -56,6 +57,9 @@ STRDISPLAYWIDTH_REGEX = re.compile(
   '^strdisplaywidth\\( ?\'(?P<text>.+)\' ?\\)$' )
 REDIR_START_REGEX = re.compile( '^redir => (?P<variable>[\\w:]+)$' )
 REDIR_END_REGEX = re.compile( '^redir END$' )
+GLOBALS_WITH_PREFIX_REGEX = re.compile(
+  '^filter\\( copy\\( g: \\), '
+  '"stridx\\( v:key, \'(?P<prefix>\\w+)\' \\) == 0" \\)$' )
 EXISTS_REGEX = re.compile( '^exists\\( \'(?P<option>[\\w:]+)\' \\)$' )
 LET_REGEX = re.compile( '^let (?P<option>[\\w:]+) = (?P<value>.*)$' )
 HAS_PATCH_REGEX = re.compile( '^has\\( \'patch(?P<patch>\\d+)\' \\)$' )
@@ -192,10 +196,11 @@ def _MockVimOptionsEval( value ):
   if result is not None:
     return result
 
-  if value == 'keys( g: )':
+  match = GLOBALS_WITH_PREFIX_REGEX.search( value )
+  if match:
     global_options = {}
     for key, value in VIM_OPTIONS.items():
-      if key.startswith( 'g:' ):
+      if key.startswith( 'g:' + match.group( 'prefix' ) ):
         global_options[ key[ 2: ] ] = value
     return global_options
 
@@ -217,9 +222,16 @@ def _MockVimFunctionsEval( value ):
   if value == 'shiftwidth()':
     return 2
 
+  if value.startswith( 'globpath( &runtimepath, ' ):
+    return []
+
   if value.startswith( 'has( "' ):
     return False
 
+  return _MockVimSignsEval( value )
+
+
+def _MockVimSignsEval( value ):
   match = re.match( 'sign_getplaced\\( (?P<bufnr>\\d+), '
                     '{ "group": "ycm_signs" } \\)', value )
   if match:
@@ -296,6 +308,12 @@ def _MockVimVersionEval( value ):
       raise RuntimeError( 'Vim version is not set.' )
     return VIM_VERSION.major * 100 + VIM_VERSION.minor
 
+  if value == 'v:versionlong':
+    if not isinstance( VIM_VERSION, Version ):
+      raise RuntimeError( 'Vim version is not set.' )
+    return ( VIM_VERSION.major * 1000000 + VIM_VERSION.minor * 10000 +
+             VIM_VERSION.patch )
+
   return None
 
 
@@ -406,6 +424,8 @@ class VimBuffer:
                         return 5
                       return [ 'a', 'b', 'c' ]"""
 
+  changedticks = itertools.count( 1 )
+
   def __init__( self, name,
                       number = 1,
                       contents = [ '' ],
@@ -424,7 +444,9 @@ class VimBuffer:
     self.bufhidden = bufhidden
     self.omnifunc = omnifunc
     self.omnifunc_name = omnifunc.__name__ if omnifunc else ''
-    self.changedtick = 1
+    # Make sure the data of a buffer is never mistaken for the data of another
+    # buffer from another test.
+    self.changedtick = next( VimBuffer.changedticks )
     self.options = {
      'mod': modified,
      'bh': bufhidden
@@ -444,6 +466,7 @@ class VimBuffer:
 
 
   def __setitem__( self, key, value ):
+    self.changedtick = next( VimBuffer.changedticks )
     return self.contents.__setitem__( key, value )
 
 
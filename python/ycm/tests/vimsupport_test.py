@@ -22,7 +22,7 @@ MockVimModule()
 
 from ycm import vimsupport
 from hamcrest import ( assert_that, calling, contains_exactly, empty, equal_to,
-                       has_entry, raises )
+                       has_entry, is_not, raises, same_instance )
 from unittest import TestCase
 from unittest.mock import MagicMock, call, patch
 from ycmd.utils import ToBytes
@@ -1477,6 +1477,25 @@ class VimsupportTest( TestCase ):
     vim_current.buffer.options.__setitem__.assert_not_called()
 
 
+  @patch( 'vim.eval', new_callable = ExtendedMock,
+          return_value = [ [ '1', '2' ], [ '2', '3' ] ] )
+  def test_VisibleBufferNumbers( self, vim_eval ):
+    assert_that( vimsupport.VisibleBufferNumbers(), equal_to( { 1, 2, 3 } ) )
+    vim_eval.assert_called_once_with(
+      'map( range( 1, tabpagenr( "$" ) ), "tabpagebuflist( v:val )" )' )
+
+
+  @patch( 'vim.eval', new_callable = ExtendedMock, return_value = [ '2' ] )
+  def test_LoadedBufferNumbers( self, vim_eval ):
+    assert_that( vimsupport.LoadedBufferNumbers( [] ), equal_to( set() ) )
+    vim_eval.assert_not_called()
+
+    assert_that( vimsupport.LoadedBufferNumbers( [ 1, 2 ] ),
+                 equal_to( { 2 } ) )
+    vim_eval.assert_called_once_with(
+      'filter( [1, 2], "bufloaded( v:val )" )' )
+
+
   def test_BufferIsVisibleForFilename( self ):
     visible_buffer = VimBuffer( 'visible_filename', number = 1 )
     hidden_buffer = VimBuffer( 'hidden_filename', number = 2 )
@@ -1544,6 +1563,80 @@ class VimsupportTest( TestCase ):
                               has_entry( 'contents', 'abc\nfДa\n' ) ) )
 
 
+  def test_GetBufferData_Cached( self ):
+    vim_buffer = VimBuffer( 'filename', contents = [ 'abc' ], filetype = 'c' )
+
+    with MockVimBuffers( [ vim_buffer ], [ vim_buffer ] ):
+      buffer_data = vimsupport.GetBufferData( vim_buffer )
+      assert_that( buffer_data, equal_to( { 'contents': 'abc\n',
+                                            'filetypes': [ 'c' ] } ) )
+      assert_that( vimsupport.GetBufferData( vim_buffer ),
+                   same_instance( buffer_data ) )
+
+      vim_buffer[ : ] = [ 'def' ]
+      assert_that( vimsupport.GetBufferData( vim_buffer ),
+                   equal_to( { 'contents': 'def\n', 'filetypes': [ 'c' ] } ) )
+
+      vim_buffer.filetype = 'cpp'
+      assert_that( vimsupport.GetBufferData( vim_buffer ),
+                   equal_to( { 'contents': 'def\n',
+                               'filetypes': [ 'cpp' ] } ) )
+
+      buffer_data = vimsupport.GetBufferData( vim_buffer )
+      vimsupport.ForgetBufferData( vim_buffer.number )
+      assert_that( vimsupport.GetBufferData( vim_buffer ),
+                   is_not( same_instance( buffer_data ) ) )
+
+
+  @patch( 'ycm.vimsupport.LARGE_FILE_WINDOW_STEP', 2 )
+  @patch( 'ycm.vimsupport.LARGE_FILE_BUFFERS', set() )
+  @patch( 'ycm.vimsupport.FILETYPES_WITHOUT_SEMANTIC_COMPLETER', set() )
+  def test_GetBufferData_LargeFile( self ):
+    contents = [ str( line ) for line in range( 1, 11 ) ]
+    vim_buffer = VimBuffer( 'filename', contents = contents, filetype = 'c' )
+    vimsupport.EnableLargeFileMode( vim_buffer.number )
+
+    with MockVimBuffers( [ vim_buffer ], [ vim_buffer ], ( 7, 1 ) ) as vim:
+      # Semantic engines get the whole contents, including until the server
+      # answers whether there is one for the filetype.
+      assert_that( vimsupport.GetBufferData( vim_buffer ), equal_to( {
+        'contents': '1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n',
+        'filetypes': [ 'c' ] } ) )
+      vimsupport.SetSemanticCompleterAvailable( 'c', True )
+      assert_that( vimsupport.GetBufferData( vim_buffer ), equal_to( {
+        'contents': '1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n',
+        'filetypes': [ 'c' ] } ) )
+
+      # Otherwise, the first lines and the lines around the cursor are sent.
+      vimsupport.SetSemanticCompleterAvailable( 'c', False )
+      buffer_data = vimsupport.GetBufferData( vim_buffer )
+      assert_that( buffer_data, equal_to( {
+        'contents': '1\n2\n\n\n5\n6\n7\n8\n9\n10\n',
+        'filetypes': [ 'c' ] } ) )
+
+      # The same contents are sent while the cursor stays around these lines.
+      vim.current.window.cursor = ( 8, 1 )
+      assert_that( vimsupport.GetBufferData( vim_buffer ),
+                   same_instance( buffer_data ) )
+
+      vim.current.window.cursor = ( 3, 1 )
+      assert_that( vimsupport.GetBufferData( vim_buffer ), equal_to( {
+        'contents': '1\n2\n3\n4\n5\n6\n\n\n\n\n',
+        'filetypes': [ 'c' ] } ) )
+
+      # Completer commands get the whole contents.
+      assert_that( vimsupport.GetBufferData( vim_buffer,
+                                             full_contents = True ),
+                   equal_to( {
+                     'contents': '1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n',
+                     'filetypes': [ 'c' ] } ) )
+
+      vimsupport.ForgetLargeFile( vim_buffer.number )
+      assert_that( vimsupport.GetBufferData( vim_buffer ), equal_to( {
+        'contents': '1\n2\n3\n4\n5\n6\n7\n8\n9\n10\n',
+        'filetypes': [ 'c' ] } ) )
+
+
   def test_GetBufferFilepath_NoBufferName_UnicodeWorkingDirectory( self ):
     vim_buffer = VimBuffer( '', number = 42 )
     unicode_dir = PathToTestFile( 'uni¢od€' )
@@ -1573,6 +1666,49 @@ class VimsupportTest( TestCase ):
     assert_that( vimsupport.CurrentLineContents(), equal_to( 'fДa' ) )
 
 
+  def test_CurrentLineContentsAndCodepointColumn( self ):
+    for line, byte_column, codepoint_column in [
+      ( 'abc', 2, 2 ),
+      ( 'abc', 5, 3 ),
+      ( 'fДa', 1, 1 ),
+      ( 'fДa', 3, 2 ),
+      ( 'fДa', 4, 3 ),
+      ( 'ДД😀a', 12, 4 ),
+      ( 'ДД😀a', 20, 4 ),
+    ]:
+      with self.subTest( line = line, byte_column = byte_column ):
+        current_buffer = VimBuffer( 'buffer', contents = [ line ] )
+        with MockVimBuffers( [ current_buffer ],
+                             [ current_buffer ],
+                             ( 1, byte_column ) ):
+          assert_that( vimsupport.CurrentLineContentsAndCodepointColumn(),
+                       contains_exactly( line, codepoint_column ) )
+          assert_that( vimsupport.CurrentLineBytes(),
+                       equal_to( ToBytes( line ) ) )
+
+
+  def test_CurrentLineContentsAndCodepointColumn_CachedUntilLineChanges(
+      self ):
+    current_buffer = VimBuffer( 'buffer', contents = [ 'fДa' ] )
+    with MockVimBuffers( [ current_buffer ],
+                         [ current_buffer ],
+                         ( 1, 3 ) ) as vim:
+      with patch( 'ycm.vimsupport.ToBytes',
+                  side_effect = ToBytes ) as to_bytes:
+        assert_that( vimsupport.CurrentLineContentsAndCodepointColumn(),
+                     contains_exactly( 'fДa', 2 ) )
+        vimsupport.CurrentLineBytes()
+        vim.current.window.cursor = ( 1, 4 )
+        assert_that( vimsupport.CurrentLineContentsAndCodepointColumn(),
+                     contains_exactly( 'fДa', 3 ) )
+        assert_that( to_bytes.call_count, equal_to( 1 ) )
+
+        vim.current.line = 'fДab'
+        assert_that( vimsupport.CurrentLineContentsAndCodepointColumn(),
+                     contains_exactly( 'fДab', 3 ) )
+        assert_that( to_bytes.call_count, equal_to( 2 ) )
+
+
   @patch( 'vim.eval', side_effect = lambda x: x )
   def test_VimExpressionToPythonType_IntAsUnicode( *args ):
     assert_that( vimsupport.VimExpressionToPythonType( '123' ),
@@ -27,10 +27,13 @@ MockVimModule()
 
 import vim
 
+import json
 import os
 import sys
+import tempfile
 from hamcrest import ( assert_that, contains_exactly, empty, equal_to,
-                       has_entries, is_in, is_not, matches_regexp )
+                       has_entries, has_key, instance_of, is_in, is_not,
+                       less_than_or_equal_to, matches_regexp, starts_with )
 from unittest.mock import call, MagicMock, patch
 from unittest import TestCase
 
@@ -44,10 +47,13 @@ from ycm.tests import ( StopServer,
 from ycm.client.base_request import _LoadExtraConfFile
 from ycm.youcompleteme import YouCompleteMe
 from ycmd.responses import ServerError
+from ycmd.utils import WaitUntilProcessIsTerminated
 from ycm.tests.mock_utils import ( MockAsyncServerResponseDone,
                                    MockAsyncServerResponseInProgress,
                                    MockAsyncServerResponseException )
 
+STATS_FILE = os.path.join( tempfile.gettempdir(), 'ycm_stats_test.jsonl' )
+
 
 def RunNotifyUserIfServerCrashed( ycm, post_vim_message, test ):
   StopServer( ycm )
@@ -285,7 +291,7 @@ class YouCompleteMeTest( TestCase ):
         StopServer( ycm )
 
 
-  @YouCompleteMeInstance()
+  @YouCompleteMeInstance( { 'g:ycm_server_auto_restart': 0 } )
   @patch( 'ycm.vimsupport.PostVimMessage', new_callable = ExtendedMock )
   def test_YouCompleteMe_NotifyUserIfServerCrashed_UnexpectedCore(
       self, ycm, post_vim_message ):
@@ -325,7 +331,7 @@ class YouCompleteMeTest( TestCase ):
     } )
 
 
-  @YouCompleteMeInstance()
+  @YouCompleteMeInstance( { 'g:ycm_server_auto_restart': 0 } )
   @patch( 'ycm.vimsupport.PostVimMessage', new_callable = ExtendedMock )
   def test_YouCompleteMe_NotifyUserIfServerCrashed_UnexpectedExitCode(
       self, ycm, post_vim_message ):
@@ -339,6 +345,72 @@ class YouCompleteMeTest( TestCase ):
     } )
 
 
+  @YouCompleteMeInstance()
+  @patch( 'ycm.vimsupport.PostVimMessage', new_callable = ExtendedMock )
+  def test_YouCompleteMe_NotifyUserIfServerCrashed_ScheduleRestart(
+      self, ycm, post_vim_message ):
+    message = (
+      "The ycmd server SHUT DOWN \\(restarting it in 1 seconds\\). "
+      "Unexpected exit code 1. Type "
+      "':YcmToggleLogs ycmd_\\d+_stderr_.+.log' to check the logs." )
+    RunNotifyUserIfServerCrashed( ycm, post_vim_message, {
+      'return_code': 1,
+      'expected_message': matches_regexp( message )
+    } )
+    assert_that( ycm.ServerCrashCount(), equal_to( 1 ) )
+    assert_that( ycm.ServerRecoveryDelay(), less_than_or_equal_to( 1000 ) )
+
+
+  @YouCompleteMeInstance()
+  @patch( 'ycm.vimsupport.PostVimMessage', new_callable = ExtendedMock )
+  def test_YouCompleteMe_NotifyUserIfServerCrashed_NoRestartForMissingCore(
+      self, ycm, post_vim_message ):
+    RunNotifyUserIfServerCrashed( ycm, post_vim_message, {
+      'return_code': 4,
+      'expected_message': starts_with( 'The ycmd server SHUT DOWN (restart '
+                                       "with ':YcmRestartServer')." )
+    } )
+    assert_that( ycm.ServerRecoveryDelay(), equal_to( -1 ) )
+
+
+  @YouCompleteMeInstance()
+  def test_YouCompleteMe_ScheduleServerRecovery_ExponentialBackoff( self, ycm ):
+    delays = [ ycm._ScheduleServerRecovery() for _ in range( 6 ) ]
+    assert_that( delays, contains_exactly( 1, 2, 4, 8, 16, None ) )
+
+
+  @YouCompleteMeInstance()
+  def test_YouCompleteMe_RecoverServer_ReplaysOpenBuffers( self, ycm ):
+    current_buffer = VimBuffer( 'current_buffer', number = 1 )
+    visible_buffer = VimBuffer( 'visible_buffer', number = 2 )
+    hidden_buffer = VimBuffer( 'hidden_buffer', number = 3 )
+    with MockVimBuffers( [ current_buffer, visible_buffer, hidden_buffer ],
+                         [ current_buffer, visible_buffer ] ):
+      for buffer_number in [ 3, 2, 1 ]:
+        ycm.Buffer( buffer_number )
+
+      StopServer( ycm )
+      ycm._server_popen = MagicMock( autospec = True )
+      ycm._server_popen.poll.return_value = 1
+      ycm.NotifyUserIfServerCrashed()
+      ycm.RecoverServer()
+      WaitUntilReady()
+
+      with patch( 'ycm.vimsupport.BufferIsLoaded', return_value = True ):
+        with patch( 'ycm.youcompleteme.SendEventNotificationAsync' ) as send:
+          ycm.ReplayBuffers()
+          assert_that( send.call_args_list, contains_exactly(
+            call( 'BufferVisit', 2 ),
+            call( 'FileReadyToParse', 2, {} ),
+            call( 'BufferVisit', 3 )
+          ) )
+
+          # Buffers are only replayed once.
+          send.reset_mock()
+          ycm.ReplayBuffers()
+          send.assert_not_called()
+
+
   @YouCompleteMeInstance( { 'g:ycm_extra_conf_vim_data': [ 'tempname()' ] } )
   @patch( 'ycm.vimsupport.VimSupportsPopupWindows', return_value=True )
   def test_YouCompleteMe_DebugInfo_ServerRunning( self, ycm, *args ):
@@ -362,6 +434,11 @@ class YouCompleteMeTest( TestCase ):
           '[\\w\\W]*'
           'Server running at: .+\n'
           'Server process ID: \\d+\n'
+          'Server crashes: 0\n'
+          '(Server round-trip time: [\\d.]+ ms \\(\\d+ requests\\)\n)?'
+          '(Request latencies:\n(  \\w+: .+\n)+)?'
+          'Client buffers: \\d+ \\([\\d.]+ KiB\\)\n'
+          '(  Buffer \\d+: [\\d.]+ KiB\n)*'
           'Server logfiles:\n'
           '  .+\n'
           '  .+' )
@@ -382,6 +459,11 @@ class YouCompleteMeTest( TestCase ):
           'Server errored, no debug info from server\n'
           'Server running at: .+\n'
           'Server process ID: \\d+\n'
+          'Server crashes: 0\n'
+          '(Server round-trip time: [\\d.]+ ms \\(\\d+ requests\\)\n)?'
+          '(Request latencies:\n(  \\w+: .+\n)+)?'
+          'Client buffers: \\d+ \\([\\d.]+ KiB\\)\n'
+          '(  Buffer \\d+: [\\d.]+ KiB\n)*'
           'Server logfiles:\n'
           '  .+\n'
           '  .+' )
@@ -398,6 +480,196 @@ class YouCompleteMeTest( TestCase ):
                  f'Logfile { client_logfile } was not removed.' )
 
 
+  @YouCompleteMeInstance( { 'g:ycm_stats_file': STATS_FILE } )
+  def test_YouCompleteMe_OnVimLeave_AppendStats( self, ycm ):
+    if os.path.exists( STATS_FILE ):
+      os.remove( STATS_FILE )
+    self.addCleanup( os.remove, STATS_FILE )
+    ycm.OnVimLeave()
+    with open( STATS_FILE ) as stats_file:
+      lines = stats_file.readlines()
+    assert_that( lines, contains_exactly( starts_with( '{' ) ) )
+    assert_that( json.loads( lines[ 0 ] ),
+                 has_entries( { 'time': instance_of( int ),
+                                'session_seconds': instance_of( int ),
+                                'stats': has_key( 'requests' ) } ) )
+
+
+  @YouCompleteMeInstance( { 'g:ycm_server_standby': 1 } )
+  @patch( 'ycm.vimsupport.PostVimMessage' )
+  def test_YouCompleteMe_RestartServer_SwapsInStandbyServer( self, ycm, *args ):
+    standby_server = ycm._standby_server
+    assert_that( standby_server, is_not( None ) )
+
+    ycm.RestartServer()
+
+    assert_that( ycm.ServerPid(), equal_to( standby_server.popen.pid ) )
+    WaitUntilReady()
+    assert_that( ycm.CheckIfServerIsReady(), equal_to( True ) )
+    # A new standby server is started once the swapped in server is ready.
+    assert_that( ycm._standby_server, is_not( None ) )
+    assert_that( ycm._standby_server.popen.pid,
+                 is_not( standby_server.popen.pid ) )
+
+
+  @YouCompleteMeInstance( { 'g:ycm_server_standby': 1 } )
+  @patch( 'ycm.vimsupport.PostVimMessage' )
+  def test_YouCompleteMe_RestartServer_DiscardsOutdatedStandbyServer(
+      self, ycm, *args ):
+    standby_server = ycm._standby_server
+
+    SetVariableValue( 'g:ycm_max_num_candidates', 10 )
+    ycm.RestartServer()
+
+    assert_that( ycm.ServerPid(), is_not( standby_server.popen.pid ) )
+    WaitUntilProcessIsTerminated( standby_server.popen )
+    WaitUntilReady()
+
+
+  @YouCompleteMeInstance( { 'g:ycm_shared_server': 1 } )
+  @patch( 'ycm.shared_server.UnregisterClient', return_value = 1 )
+  @patch( 'ycm.vimsupport.PostVimMessage' )
+  def test_YouCompleteMe_RestartServer_SharedServerWithOtherClients(
+      self, ycm, post_vim_message, *args ):
+    shared_server_popen = ycm._server_popen
+    shared_server_pid = ycm.ServerPid()
+    self.addCleanup( WaitUntilProcessIsTerminated, shared_server_popen )
+    self.addCleanup( shared_server_popen.terminate )
+
+    with patch( 'ycm.youcompleteme.SendShutdownRequest' ) as shutdown:
+      ycm.RestartServer()
+
+    # The shared server is left running for the other clients.
+    shutdown.assert_not_called()
+    post_vim_message.assert_called_once_with(
+      'The shared ycmd server is used by other Vim instances; starting a '
+      'private ycmd server for this one...' )
+    assert_that( ycm.ServerPid(), is_not( shared_server_pid ) )
+    assert_that( ycm._UseSharedServer(), equal_to( False ) )
+    WaitUntilReady()
+
+
+  @YouCompleteMeInstance( { 'g:ycm_echo_current_diagnostic': 1 } )
+  def test_YouCompleteMe_ReloadOptions_UpdateBuffers( self, ycm ):
+    current_buffer = VimBuffer( 'current_buffer' )
+    with MockVimBuffers( [ current_buffer ], [ current_buffer ] ):
+      diag_interface = ycm.CurrentBuffer().diag_interface
+      with UserOptions( { 'g:ycm_echo_current_diagnostic': 0 } ):
+        ycm.ReloadOptions()
+
+      assert_that( ycm._user_options.echo_current_diagnostic, equal_to( 0 ) )
+      assert_that( diag_interface._user_options.echo_current_diagnostic,
+                   equal_to( 0 ) )
+
+
+  @YouCompleteMeInstance()
+  @patch( 'ycm.youcompleteme.SendCompleterAvailableRequestAsync' )
+  def test_YouCompleteMe_FiletypeCompleterExistsForFiletype_NonBlocking(
+      self, ycm, send_request ):
+    request = send_request.return_value
+    request.Done.return_value = False
+    with patch.object( ycm, '_completer_availability_cache' ) as cache:
+      cache.Get.return_value = None
+
+      # Don't wait for the server to answer.
+      for _ in range( 2 ):
+        assert_that( ycm.FiletypeCompleterExistsForFiletype( 'cpp' ),
+                     equal_to( False ) )
+      send_request.assert_called_once_with( 'cpp' )
+
+      request.Done.return_value = True
+      request.Response.return_value = True
+      assert_that( ycm.FiletypeCompleterExistsForFiletype( 'cpp' ),
+                   equal_to( True ) )
+      cache.Set.assert_called_once_with( 'cpp', True )
+      send_request.assert_called_once_with( 'cpp' )
+
+
+  @YouCompleteMeInstance()
+  @patch( 'ycm.youcompleteme.SendCompleterAvailableRequestAsync' )
+  def test_YouCompleteMe_FiletypeCompleterExistsForFiletype_Blocking(
+      self, ycm, send_request ):
+    request = send_request.return_value
+    request.Done.return_value = False
+
+    def Response():
+      # The server answers while waiting for it.
+      request.Done.return_value = True
+      return True
+
+    request.Response.side_effect = Response
+    with patch.object( ycm, '_completer_availability_cache' ) as cache:
+      cache.Get.return_value = None
+
+      assert_that( ycm.FiletypeCompleterExistsForFiletype( 'cpp',
+                                                           block = True ),
+                   equal_to( True ) )
+      cache.Set.assert_called_once_with( 'cpp', True )
+      send_request.assert_called_once_with( 'cpp' )
+
+
+  @YouCompleteMeInstance()
+  @patch( 'ycm.youcompleteme.SendCompleterAvailableRequestAsync' )
+  def test_YouCompleteMe_FiletypeCompleterExistsForFiletype_Cached(
+      self, ycm, send_request ):
+    request = send_request.return_value
+    request.Done.return_value = False
+    with patch.object( ycm, '_completer_availability_cache' ) as cache:
+      cache.Get.return_value = True
+
+      # The server is still asked in case the answer changed.
+      assert_that( ycm.FiletypeCompleterExistsForFiletype( 'cpp' ),
+                   equal_to( True ) )
+      send_request.assert_called_once_with( 'cpp' )
+
+      request.Done.return_value = True
+      request.Response.return_value = False
+      assert_that( ycm.FiletypeCompleterExistsForFiletype( 'cpp' ),
+                   equal_to( False ) )
+      cache.Set.assert_called_once_with( 'cpp', False )
+
+
+  @YouCompleteMeInstance()
+  @patch( 'ycm.youcompleteme.YouCompleteMe.NativeFiletypeCompletionUsable',
+          return_value = True )
+  @patch( 'ycm.youcompleteme.YouCompleteMe.'
+          'SignatureHelpAvailableRequestComplete',
+          return_value = True )
+  @patch( 'ycm.signature_help.ShouldUseSignatureHelp', return_value = False )
+  @patch( 'ycm.youcompleteme.SignatureHelpRequest',
+          side_effect = lambda request_data: MagicMock(
+            request_data = request_data ) )
+  def test_YouCompleteMe_SendSignatureHelpRequest_SameArgument(
+      self, ycm, signature_help_request, *args ):
+    def SendSignatureHelpRequest( line, column ):
+      current_buffer = VimBuffer( 'buffer', filetype = 'cpp',
+                                  contents = [ line ] )
+      with MockVimBuffers( [ current_buffer ],
+                           [ current_buffer ],
+                           ( 1, column - 1 ) ):
+        ycm._latest_completion_request = MagicMock( request_data = {
+          'filepath': 'buffer',
+          'line_num': 1,
+          'column_num': column
+        } )
+        sent = ycm.SendSignatureHelpRequest()
+        ycm.UpdateSignatureHelp( { 'signatures': [ { 'label': 'foo()' } ] } )
+        return sent
+
+    ycm._signature_help_available_requests[ 'cpp' ] = MagicMock()
+    ycm._signature_help_state.anchor = ( 0, 4 )
+    assert_that( SendSignatureHelpRequest( 'foo( a, b', 8 ), equal_to( True ) )
+    assert_that( SendSignatureHelpRequest( 'foo( a, bc', 9 ),
+                 equal_to( False ) )
+    assert_that( SendSignatureHelpRequest( 'foo( a, bc, ', 12 ),
+                 equal_to( True ) )
+    assert_that( SendSignatureHelpRequest( 'foo( a, bc, f( ', 15 ),
+                 equal_to( True ) )
+    assert_that( SendSignatureHelpRequest( 'foo( a, bc, f( ', 15 ),
+                 equal_to( True ) )
+    assert_that( signature_help_request.call_count, equal_to( 4 ) )
+
+
   @YouCompleteMeInstance( { 'g:ycm_keep_logfiles': 1 } )
   def test_YouCompleteMe_OnVimLeave_KeepClientLogfile( self, ycm ):
     client_logfile = ycm._client_logfile
@@ -1199,6 +1471,23 @@ class YouCompleteMeTest( TestCase ):
         assert_that( ycm.OnPeriodicTick(), equal_to( True ) )
 
 
+  @YouCompleteMeInstance()
+  @patch( 'ycm.client.messages_request.MessagesPoll.Poll', return_value = True )
+  def test_YouCompleteMe_OnPeriodicTick_OnePollPerFiletype( self, ycm, poll ):
+    cpp_buffer = VimBuffer( '/foo.cpp', filetype = 'cpp', number = 1 )
+    other_cpp_buffer = VimBuffer( '/bar.cpp', filetype = 'cpp', number = 2 )
+    text_buffer = VimBuffer( '/baz.txt', filetype = 'text', number = 3 )
+    buffers = [ cpp_buffer, other_cpp_buffer, text_buffer ]
+    ycm._available_completers[ 'text' ] = False
+
+    with MockVimBuffers( buffers, buffers ):
+      assert_that( ycm.OnPeriodicTick(), equal_to( True ) )
+
+    poll.assert_called_once_with( ycm, cpp_buffer )
+    assert_that( list( ycm._message_poll_requests ),
+                 contains_exactly( 'cpp' ) )
+
+
   @YouCompleteMeInstance()
   @patch( 'ycm.youcompleteme.YouCompleteMe.FiletypeCompleterExistsForFiletype',
           return_value = True )
@@ -21,13 +21,13 @@ import json
 import re
 from collections import defaultdict, namedtuple
 from functools import lru_cache as memoize
-from ycmd.utils import ( ByteOffsetToCodepointOffset,
-                         GetCurrentDirectory,
+from ycmd.utils import ( GetCurrentDirectory,
                          JoinLinesAsUnicode,
                          OnMac,
                          OnWindows,
                          ToBytes,
                          ToUnicode )
+from ycm import metrics
 
 BUFFER_COMMAND_MAP = { 'same-buffer'      : 'edit',
                        'split'            : 'split',
@@ -51,6 +51,26 @@ NO_SELECTION_MADE_MSG = "No valid selection was made; aborting."
 # those same file names back to their originating buffer numbers.
 MADEUP_FILENAME_TO_BUFFER_NUMBER = {}
 
+# Several requests are usually sent for the same buffer contents (completion,
+# signature help, parse, semantic highlighting, inlay hints, etc.) so the data
+# of a buffer is only rebuilt when its changedtick or its filetypes change. Maps
+# a buffer number to its changedtick and data.
+BUFFER_DATA_CACHE = {}
+
+# Buffers larger than g:ycm_disable_for_files_larger_than_kb when
+# g:ycm_large_file_mode is set. If the server has no semantic completer for
+# their filetypes, only the first lines of these buffers and a window of lines
+# around the cursor are sent to the server, the other lines being sent empty so
+# that line numbers are unchanged. The window moves by steps so that the server
+# gets the same contents while the cursor stays around the same lines. Semantic
+# engines always get the whole contents since they would otherwise report
+# errors about the missing code, and so do completer commands since they may
+# return edits to apply to the buffer.
+LARGE_FILE_BUFFERS = set()
+LARGE_FILE_WINDOW_STEP = 2000
+# Filetypes the server answered it has no semantic completer for.
+FILETYPES_WITHOUT_SEMANTIC_COMPLETER = set()
+
 NO_COMPLETIONS = {
   'line': -1,
   'column': -1,
@@ -97,15 +117,55 @@ def CurrentLineContents():
   return ToUnicode( vim.current.line )
 
 
+def CurrentLineBytes():
+  """Returns the line contents as UTF-8 bytes."""
+  line = CurrentLineContents()
+  if line.isascii():
+    return line.encode( 'ascii' )
+  return _OffsetsForLine( line ).line_bytes
+
+
 def CurrentLineContentsAndCodepointColumn():
   """Returns the line contents as a unicode string and the 0-based current
   column as a codepoint offset. If the current column is outside the line,
   returns the column position at the end of the line."""
   line = CurrentLineContents()
   byte_column = CurrentColumn()
-  # ByteOffsetToCodepointOffset expects 1-based offset.
-  column = ByteOffsetToCodepointOffset( line, byte_column + 1 ) - 1
-  return line, column
+  # Checking that a string is ASCII takes constant time; byte and codepoint
+  # offsets are the same in that case.
+  if line.isascii():
+    return line, min( byte_column, len( line ) )
+  return line, _OffsetsForLine( line ).CodepointColumn( byte_column )
+
+
+class _LineOffsets:
+  """Converts byte offsets of a non-ASCII line to codepoint offsets. The
+  current line is converted several times per keystroke (identifier checks,
+  completion and signature help requests) so the UTF-8 encoding of the line
+  and the converted offsets are kept until the line changes."""
+
+  def __init__( self, line ):
+    self.line = line
+    self.line_bytes = ToBytes( line )
+    self._codepoint_columns = {}
+
+
+  def CodepointColumn( self, byte_column ):
+    column = self._codepoint_columns.get( byte_column )
+    if column is None:
+      column = len( ToUnicode( self.line_bytes[ : byte_column ] ) )
+      self._codepoint_columns[ byte_column ] = column
+    return column
+
+
+_current_line_offsets = _LineOffsets( '' )
+
+
+def _OffsetsForLine( line ):
+  global _current_line_offsets
+  if _current_line_offsets.line != line:
+    _current_line_offsets = _LineOffsets( line )
+  return _current_line_offsets
 
 
 def TextAfterCursor():
@@ -122,19 +182,108 @@ def BufferModified( buffer_object ):
   return buffer_object.options[ 'mod' ]
 
 
-def GetBufferData( buffer_object ):
-  return {
+def GetBufferData( buffer_object, full_contents = False ):
+  """Returns the contents and filetypes of |buffer_object|. Only part of the
+  contents of large files is returned unless |full_contents| is set."""
+  # Requests share the returned dictionary so it must not be modified.
+  changed_tick = GetBufferChangedTick( buffer_object.number )
+  filetypes = FiletypesForBuffer( buffer_object )
+  window = None if full_contents else _LargeFileWindow( buffer_object,
+                                                        filetypes )
+  cached_tick, cached_window, buffer_data = BUFFER_DATA_CACHE.get(
+    buffer_object.number, ( None, None, None ) )
+  if ( changed_tick and
+       changed_tick == cached_tick and
+       window == cached_window and
+       buffer_data[ 'filetypes' ] == filetypes ):
+    metrics.RecordCacheLookup( 'buffer_data', True )
+    return buffer_data
+  metrics.RecordCacheLookup( 'buffer_data', False )
+
+  if window is None:
+    contents = JoinLinesAsUnicode( buffer_object )
+  else:
+    contents = _LargeFileContents( buffer_object, window )
+  buffer_data = {
     # Add a newline to match what gets saved to disk. See #1455 for details.
-    'contents': JoinLinesAsUnicode( buffer_object ) + '\n',
-    'filetypes': FiletypesForBuffer( buffer_object )
+    'contents': contents + '\n',
+    'filetypes': filetypes
   }
+  BUFFER_DATA_CACHE[ buffer_object.number ] = ( changed_tick,
+                                                window,
+                                                buffer_data )
+  return buffer_data
+
+
+def ForgetBufferData( buffer_number ):
+  BUFFER_DATA_CACHE.pop( buffer_number, None )
+
+
+def EnableLargeFileMode( buffer_number ):
+  LARGE_FILE_BUFFERS.add( buffer_number )
+  ForgetBufferData( buffer_number )
 
 
-def GetUnsavedAndSpecifiedBufferData( included_buffer, included_filepath ):
+def ForgetLargeFile( buffer_number ):
+  LARGE_FILE_BUFFERS.discard( buffer_number )
+
+
+def IsLargeFile( buffer_number ):
+  return buffer_number in LARGE_FILE_BUFFERS
+
+
+def SetSemanticCompleterAvailable( filetype, available ):
+  if available:
+    FILETYPES_WITHOUT_SEMANTIC_COMPLETER.discard( filetype )
+  else:
+    FILETYPES_WITHOUT_SEMANTIC_COMPLETER.add( filetype )
+
+
+def ForgetSemanticCompleterAvailability():
+  FILETYPES_WITHOUT_SEMANTIC_COMPLETER.clear()
+
+
+def _LargeFileWindow( buffer_object, filetypes ):
+  """Returns the 0-based range of lines sent around the cursor for a large
+  file of filetypes without semantic completer or None for other buffers."""
+  if buffer_object.number not in LARGE_FILE_BUFFERS:
+    return None
+  # Until the server answers, the filetypes may have a semantic completer.
+  if not all( filetype in FILETYPES_WITHOUT_SEMANTIC_COMPLETER
+              for filetype in filetypes ):
+    return None
+  if buffer_object.number == vim.current.buffer.number:
+    line = vim.current.window.cursor[ 0 ] - 1
+  else:
+    line = GetIntValue( f'getbufinfo( { buffer_object.number } )[ 0 ].lnum' )
+    line = max( line - 1, 0 )
+  # The cursor is at least one step away from the end of the window.
+  step = line // LARGE_FILE_WINDOW_STEP
+  return ( max( step - 1, 0 ) * LARGE_FILE_WINDOW_STEP,
+           ( step + 2 ) * LARGE_FILE_WINDOW_STEP )
+
+
+def _LargeFileContents( buffer_object, window ):
+  # The first lines are sent too as they usually hold the includes or imports.
+  line_count = len( buffer_object )
+  head_end = min( LARGE_FILE_WINDOW_STEP, line_count )
+  start = min( max( window[ 0 ], head_end ), line_count )
+  end = min( max( window[ 1 ], start ), line_count )
+  lines = buffer_object[ : head_end ]
+  lines.extend( [ '' ] * ( start - head_end ) )
+  lines.extend( buffer_object[ start : end ] )
+  lines.extend( [ '' ] * ( line_count - end ) )
+  return JoinLinesAsUnicode( lines )
+
+
+def GetUnsavedAndSpecifiedBufferData( included_buffer,
+                                      included_filepath,
+                                      full_contents = False ):
   """Build part of the request containing the contents and filetypes of all
   dirty buffers as well as the buffer |included_buffer| with its filepath
-  |included_filepath|."""
-  buffers_data = { included_filepath: GetBufferData( included_buffer ) }
+  |included_filepath|. See GetBufferData for |full_contents|."""
+  buffers_data = { included_filepath: GetBufferData( included_buffer,
+                                                     full_contents ) }
 
   for buffer_object in vim.buffers:
     if not BufferModified( buffer_object ):
@@ -144,7 +293,7 @@ def GetUnsavedAndSpecifiedBufferData( included_buffer, included_filepath ):
     if filepath in buffers_data:
       continue
 
-    buffers_data[ filepath ] = GetBufferData( buffer_object )
+    buffers_data[ filepath ] = GetBufferData( buffer_object, full_contents )
 
   return buffers_data
 
@@ -167,6 +316,29 @@ def BufferIsVisible( buffer_number ):
   return window_number != -1
 
 
+def BufferIsLoaded( buffer_number ):
+  return bool( GetIntValue( f'bufloaded({ buffer_number })' ) )
+
+
+def VisibleBufferNumbers():
+  """Returns the set of the numbers of the buffers displayed in a window of any
+  tab page."""
+  buffer_numbers_by_tab = vim.eval(
+    'map( range( 1, tabpagenr( "$" ) ), "tabpagebuflist( v:val )" )' )
+  return { int( buffer_number )
+           for buffer_numbers in buffer_numbers_by_tab
+           for buffer_number in buffer_numbers }
+
+
+def LoadedBufferNumbers( buffer_numbers ):
+  """Returns the set of the numbers in |buffer_numbers| of the loaded
+  buffers."""
+  if not buffer_numbers:
+    return set()
+  return { int( buffer_number ) for buffer_number in vim.eval(
+    f'filter( { list( buffer_numbers ) }, "bufloaded( v:val )" )' ) }
+
+
 def GetBufferFilepath( buffer_object ):
   if buffer_object.name:
     return os.path.abspath( ToUnicode( buffer_object.name ) )
@@ -602,8 +774,16 @@ def ConvertDiagnosticsToQfList( diagnostics ):
   return [ ConvertDiagnosticToQfFormat( x ) for x in diagnostics ]
 
 
-def GetVimGlobalsKeys():
-  return vim.eval( 'keys( g: )' )
+def GetVimGlobalsWithPrefix( prefix ):
+  """Returns a dictionary of the global variables whose names start with
+  |prefix|, without the prefix, in a single evaluation. Values are converted as
+  in VimExpressionToPythonType. Only the matching variables are evaluated to
+  avoid unicode issues with the others.
+  See https://github.com/Valloric/YouCompleteMe/pull/2151 for details."""
+  variables = vim.eval(
+    f'filter( copy( g: ), "stridx( v:key, \'{ prefix }\' ) == 0" )' )
+  return { ToUnicode( name )[ len( prefix ): ]: _VimValueToPythonType( value )
+           for name, value in variables.items() }
 
 
 def VimExpressionToPythonType( vim_expression ):
@@ -613,7 +793,10 @@ def VimExpressionToPythonType( vim_expression ):
   integer, returns an integer, otherwise returns the result converted to a
   Unicode string."""
 
-  result = vim.eval( vim_expression )
+  return _VimValueToPythonType( vim.eval( vim_expression ) )
+
+
+def _VimValueToPythonType( result ):
   if not ( isinstance( result, str ) or isinstance( result, bytes ) ):
     return result
 
@@ -20,18 +20,24 @@ import json
 import logging
 import os
 import signal
+import time
 import vim
+from collections import namedtuple
 from subprocess import PIPE
 from tempfile import NamedTemporaryFile
-from ycm import base, paths, signature_help, vimsupport
+from ycm import ( base, metrics, paths, shared_server, signature_help,
+                  startup_profile, vimsupport )
 from ycm.buffer import BufferDict
+from ycm.buffer_prefetch import BufferPrefetcher
+from ycm.completer_availability_cache import CompleterAvailabilityCache
 from ycmd import utils
-from ycmd.request_wrap import RequestWrap
-from ycm.omni_completer import OmniCompleter
-from ycm import syntax_parse
 from ycm.client.ycmd_keepalive import YcmdKeepalive
-from ycm.client.base_request import BaseRequest, BuildRequestData
-from ycm.client.completer_available_request import SendCompleterAvailableRequest
+from ycm.client.base_request import ( AdaptiveTimeout, BaseRequest,
+                                      BuildRequestData, GetRoundTripStatistics,
+                                      LatencyHistogramsSnapshot,
+                                      ResetLatencyStatistics )
+from ycm.client.completer_available_request import (
+    SendCompleterAvailableRequestAsync )
 from ycm.client.command_request import ( SendCommandRequest,
                                          SendCommandRequestAsync,
                                          GetCommandResponse )
@@ -39,9 +45,6 @@ from ycm.client.completion_request import CompletionRequest
 from ycm.client.resolve_completion_request import ResolveCompletionItem
 from ycm.client.signature_help_request import ( SignatureHelpRequest,
                                                 SigHelpAvailableByFileType )
-from ycm.client.debug_info_request import ( SendDebugInfoRequest,
-                                            FormatDebugInfoResponse )
-from ycm.client.omni_completion_request import OmniCompletionRequest
 from ycm.client.event_notification import SendEventNotificationAsync
 from ycm.client.shutdown_request import SendShutdownRequest
 from ycm.client.messages_request import MessagesPoll
@@ -71,6 +74,8 @@ signal.signal( signal.SIGINT, signal.SIG_IGN )
 HMAC_SECRET_LENGTH = 16
 SERVER_SHUTDOWN_MESSAGE = (
   "The ycmd server SHUT DOWN (restart with ':YcmRestartServer')." )
+SERVER_RECOVERY_MESSAGE = (
+  'The ycmd server SHUT DOWN (restarting it in {delay} seconds).' )
 EXIT_CODE_UNEXPECTED_MESSAGE = (
   "Unexpected exit code {code}. "
   "Type ':YcmToggleLogs {logfile}' to check the logs." )
@@ -88,8 +93,26 @@ PYTHON_TOO_OLD_MESSAGE = (
   'Please see troubleshooting guide on YCM GitHub wiki.'
 )
 SERVER_IDLE_SUICIDE_SECONDS = 1800  # 30 minutes
+# When g:ycm_server_auto_restart is set, a crashed server is restarted after a
+# delay that doubles with each consecutive crash. The count is reset once a
+# server has been running for SERVER_RECOVERY_RESET_SECONDS.
+SERVER_RECOVERY_BASE_DELAY_SECONDS = 1
+SERVER_RECOVERY_MAX_ATTEMPTS = 5
+SERVER_RECOVERY_RESET_SECONDS = 300
+# Exit codes for which restarting the server can't help. See
+# https://github.com/Valloric/ycmd#exit-codes
+SERVER_UNRECOVERABLE_EXIT_CODES = { 4, 7, 8 }
 CLIENT_LOGFILE_FORMAT = 'ycm_'
 SERVER_LOGFILE_FORMAT = 'ycmd_{port}_{std}_'
+# Only the buffers using the most memory are listed in :YcmDebugInfo.
+MAX_BUFFERS_IN_DEBUG_INFO = 10
+
+ServerProcess = namedtuple( 'ServerProcess', [ 'popen',
+                                               'location',
+                                               'hmac_secret',
+                                               'stdout',
+                                               'stderr',
+                                               'options' ] )
 
 # Flag to set a file handle inheritable by child processes on Windows. See
 # https://msdn.microsoft.com/en-us/library/ms724935.aspx
@@ -103,7 +126,13 @@ class YouCompleteMe:
     self._server_stdout = None
     self._server_stderr = None
     self._server_popen = None
+    self._standby_server = None
+    self._detached_from_shared_server = False
+    self._server_crash_count = 0
+    self._server_recovery_attempts = 0
+    self._server_recovery_time = None
     self._default_options = default_options
+    self._session_start_time = time.monotonic()
     self._ycmd_keepalive = YcmdKeepalive()
     self._SetUpLogging()
     self._SetUpServer()
@@ -112,30 +141,68 @@ class YouCompleteMe:
 
   def _SetUpServer( self ):
     self._available_completers = {}
+    vimsupport.ForgetSemanticCompleterAvailability()
+    self._completer_available_requests = {}
     self._user_notified_about_crash = False
-    self._filetypes_with_keywords_loaded = set()
+    self._ForgetDataSentToServer()
     self._server_is_ready_with_cache = False
     self._message_poll_requests = {}
+    self._buffers_to_replay = []
 
     self._latest_completion_request = None
     self._latest_signature_help_request = None
+    self._signature_help_key = None
     self._signature_help_available_requests = SigHelpAvailableByFileType()
     self._command_requests = {}
     self._next_command_request_id = 0
 
     self._signature_help_state = signature_help.SignatureHelpState()
-    self._user_options = base.GetUserOptions( self._default_options )
-    self._omnicomp = OmniCompleter( self._user_options )
+    with startup_profile.Measure( 'Options loading' ):
+      self._user_options = base.GetUserOptions( self._default_options )
+    BaseRequest.compression_threshold = (
+      self._user_options.compress_requests_larger_than_kb * 1024 )
+    self._completer_availability_cache = CompleterAvailabilityCache(
+      dict( self._user_options ) )
+    # The omnicompleter is only created when a filetype without a semantic
+    # completer needs it. See GetOmniCompleter.
+    self._omnicomp = None
     self._buffers = BufferDict( self._user_options )
+    self._buffer_prefetcher = self._CreateBufferPrefetcher()
 
     self._SetLogLevel()
 
+    self._server_start_time = startup_profile.Now()
+    self._server_running_since = time.monotonic()
+    if ( self._UseSharedServer() and
+         not shared_server.PrepareStateDirectory() ):
+      # Another user may be trying to intercept the requests.
+      self._detached_from_shared_server = True
+    if not self._UseSharedServer():
+      with startup_profile.Measure( 'Server spawn' ):
+        self._StartServer()
+      return
+
+    with shared_server.StateLock():
+      if not self._AttachToSharedServer():
+        self._StartServer()
+        self._PublishSharedServer()
+      shared_server.RegisterClient()
+
+
+  def _StartServer( self ):
+    server = self._TakeStandbyServer()
+    if not server:
+      server = self._SpawnServer()
+    if server:
+      self._UseServer( server )
+
+
+  def _SpawnServer( self ):
     hmac_secret = os.urandom( HMAC_SECRET_LENGTH )
     options_dict = dict( self._user_options )
     options_dict[ 'hmac_secret' ] = utils.ToUnicode(
       base64.b64encode( hmac_secret ) )
-    options_dict[ 'server_keep_logfiles' ] = self._user_options[
-      'keep_logfiles' ]
+    options_dict[ 'server_keep_logfiles' ] = self._user_options.keep_logfiles
 
     # The temp options file is deleted by ycmd during startup.
     with NamedTemporaryFile( delete = False, mode = 'w+' ) as options_file:
@@ -143,9 +210,6 @@ class YouCompleteMe:
 
     server_port = utils.GetUnusedLocalhostPort()
 
-    BaseRequest.server_location = 'http://127.0.0.1:' + str( server_port )
-    BaseRequest.hmac_secret = hmac_secret
-
     try:
       python_interpreter = paths.PathToPythonInterpreter()
     except RuntimeError as error:
@@ -155,27 +219,132 @@ class YouCompleteMe:
         "with ':YcmRestartServer'." )
       self._logger.exception( error_message )
       vimsupport.PostVimMessage( error_message )
-      return
+      return None
 
     args = [ python_interpreter,
              paths.PathToServerScript(),
              f'--port={ server_port }',
              f'--options_file={ options_file.name }',
-             f'--log={ self._user_options[ "log_level" ] }',
+             f'--log={ self._user_options.log_level }',
              f'--idle_suicide_seconds={ SERVER_IDLE_SUICIDE_SECONDS }' ]
 
-    self._server_stdout = utils.CreateLogfile(
+    server_stdout = utils.CreateLogfile(
         SERVER_LOGFILE_FORMAT.format( port = server_port, std = 'stdout' ) )
-    self._server_stderr = utils.CreateLogfile(
+    server_stderr = utils.CreateLogfile(
         SERVER_LOGFILE_FORMAT.format( port = server_port, std = 'stderr' ) )
-    args.append( f'--stdout={ self._server_stdout }' )
-    args.append( f'--stderr={ self._server_stderr }' )
+    args.append( f'--stdout={ server_stdout }' )
+    args.append( f'--stderr={ server_stderr }' )
 
-    if self._user_options[ 'keep_logfiles' ]:
+    if self._user_options.keep_logfiles:
       args.append( '--keep_logfiles' )
 
-    self._server_popen = utils.SafePopen( args, stdin_windows = PIPE,
-                                          stdout = PIPE, stderr = PIPE )
+    return ServerProcess(
+      popen = utils.SafePopen( args, stdin_windows = PIPE,
+                               stdout = PIPE, stderr = PIPE ),
+      location = 'http://127.0.0.1:' + str( server_port ),
+      hmac_secret = hmac_secret,
+      stdout = server_stdout,
+      stderr = server_stderr,
+      options = dict( self._user_options ) )
+
+
+  def _UseServer( self, server ):
+    BaseRequest.server_location = server.location
+    BaseRequest.hmac_secret = server.hmac_secret
+    BaseRequest.accepted_encodings = frozenset()
+    ResetLatencyStatistics()
+    self._server_popen = server.popen
+    self._server_stdout = server.stdout
+    self._server_stderr = server.stderr
+    self._ForgetDataSentToServer()
+
+
+  def _ForgetDataSentToServer( self ):
+    """Makes the next parse requests send the syntax keywords and tag files
+    again. Must be called whenever a different server is used."""
+    self._filetypes_with_keywords_loaded = set()
+    self._syntax_keywords_sent = {}
+    self._tag_files_sent = {}
+
+
+  def _SpawnStandbyServerIfNeeded( self ):
+    """Starts a second server once the current one is ready so that
+    :YcmRestartServer can swap it in without waiting for the Python interpreter
+    and the ycmd modules to load."""
+    if ( not self._user_options.server_standby or
+         self._UseSharedServer() or
+         self._standby_server ):
+      return
+    self._standby_server = self._SpawnServer()
+    if self._standby_server:
+      self._ycmd_keepalive.SetStandbyServer(
+        self._standby_server.location, self._standby_server.hmac_secret )
+
+
+  def _TakeStandbyServer( self ):
+    standby_server = self._standby_server
+    self._standby_server = None
+    self._ycmd_keepalive.SetStandbyServer( None, None )
+    if not standby_server:
+      return None
+
+    # The standby server was started with the options at that time. Discard it
+    # if the user changed them since, which is often the reason for restarting.
+    if ( standby_server.popen.poll() is not None or
+         standby_server.options != self._user_options ):
+      self._StopStandbyServer( standby_server )
+      return None
+
+    self._logger.info( 'Swapping in standby ycmd server at %s',
+                       standby_server.location )
+    return standby_server
+
+
+  def _StopStandbyServer( self, standby_server ):
+    if standby_server and standby_server.popen.poll() is None:
+      # The standby server never loaded any completer so there is nothing to
+      # shut down gracefully.
+      standby_server.popen.terminate()
+
+
+  def _UseSharedServer( self ):
+    return ( bool( self._user_options.shared_server ) and
+             shared_server.IsSupported() and
+             not self._detached_from_shared_server )
+
+
+  def _AttachToSharedServer( self ):
+    state = shared_server.ReadServerState()
+    if not state:
+      return False
+
+    BaseRequest.server_location = state[ 'server_location' ]
+    BaseRequest.hmac_secret = state[ 'hmac_secret' ]
+    BaseRequest.accepted_encodings = frozenset()
+    ResetLatencyStatistics()
+    if not BaseRequest().GetDataFromHandler( 'healthy',
+                                             display_message = False ):
+      self._logger.warning( 'Shared ycmd server at %s is not healthy',
+                            state[ 'server_location' ] )
+      shared_server.ClearServerState()
+      return False
+
+    self._logger.info( 'Attached to shared ycmd server at %s',
+                       state[ 'server_location' ] )
+    self._server_popen = shared_server.AttachedServerProcess( state[ 'pid' ] )
+    self._server_stdout, self._server_stderr = state[ 'logfiles' ]
+    self._ForgetDataSentToServer()
+    return True
+
+
+  def _PublishSharedServer( self ):
+    if not self._server_popen:
+      return
+    shared_server.PublishServerState( BaseRequest.server_location,
+                                      BaseRequest.hmac_secret,
+                                      self._server_popen.pid,
+                                      [ self._server_stdout,
+                                        self._server_stderr ] )
 
 
   def _SetUpLogging( self ):
@@ -211,7 +380,7 @@ class YouCompleteMe:
 
 
   def _SetLogLevel( self ):
-    log_level = self._user_options[ 'log_level' ]
+    log_level = self._user_options.log_level
     numeric_level = getattr( logging, log_level.upper(), None )
     if not isinstance( numeric_level, int ):
       raise ValueError( f'Invalid log level: { log_level }' )
@@ -227,6 +396,9 @@ class YouCompleteMe:
     if not self._server_is_ready_with_cache and self.IsServerAlive():
       self._server_is_ready_with_cache = BaseRequest().GetDataFromHandler(
           'ready', display_message = False )
+      if self._server_is_ready_with_cache:
+        startup_profile.Record( 'Server ready', self._server_start_time )
+        self._SpawnStandbyServerIfNeeded()
     return self._server_is_ready_with_cache
 
 
@@ -257,37 +429,153 @@ class YouCompleteMe:
       error_message = EXIT_CODE_UNEXPECTED_MESSAGE.format( code = return_code,
                                                            logfile = logfile )
 
-    if return_code != 8:
+    self._server_crash_count += 1
+    recovery_delay = None
+    if return_code not in SERVER_UNRECOVERABLE_EXIT_CODES:
+      recovery_delay = self._ScheduleServerRecovery()
+
+    if recovery_delay is not None:
+      error_message = ( SERVER_RECOVERY_MESSAGE.format( delay = recovery_delay )
+                        + ' ' + error_message )
+    elif return_code != 8:
       error_message = SERVER_SHUTDOWN_MESSAGE + ' ' + error_message
     self._logger.error( error_message )
     vimsupport.PostVimMessage( error_message )
 
 
+  def _ScheduleServerRecovery( self ):
+    """Schedules a restart of the crashed server. Returns the delay in seconds
+    before the restart or None if the server should not be restarted."""
+    if not self._user_options.server_auto_restart:
+      return None
+
+    now = time.monotonic()
+    if now - self._server_running_since > SERVER_RECOVERY_RESET_SECONDS:
+      self._server_recovery_attempts = 0
+    if self._server_recovery_attempts >= SERVER_RECOVERY_MAX_ATTEMPTS:
+      self._logger.error( 'Server crashed %s times in a row, giving up',
+                          self._server_recovery_attempts )
+      return None
+
+    delay = SERVER_RECOVERY_BASE_DELAY_SECONDS * 2 ** (
+      self._server_recovery_attempts )
+    self._server_recovery_attempts += 1
+    self._server_recovery_time = now + delay
+    return delay
+
+
+  def ServerRecoveryDelay( self ):
+    """Returns the number of milliseconds until the crashed server should be
+    restarted through RecoverServer or -1 if no restart is scheduled."""
+    if self._server_recovery_time is None:
+      return -1
+    return max( 0, int( ( self._server_recovery_time - time.monotonic() ) *
+                        1000 ) )
+
+
+  def RecoverServer( self ):
+    if self._server_recovery_time is None or self.IsServerAlive():
+      return
+    self._server_recovery_time = None
+    self._logger.info( 'Restarting crashed server (attempt %s of %s)',
+                       self._server_recovery_attempts,
+                       SERVER_RECOVERY_MAX_ATTEMPTS )
+    self._ResetServer()
+
+
+  def ServerCrashCount( self ):
+    return self._server_crash_count
+
+
+  def _ResetServer( self ):
+    open_buffers = list( self._buffers )
+    self._SetUpServer()
+    self._buffers_to_replay = open_buffers
+
+
+  def ReplayBuffers( self ):
+    """Sends the buffers that were open before the server was restarted to the
+    new server so that it doesn't wait for the user to visit them again. The
+    current buffer is sent by the FileType event triggered once the server is
+    ready; visible buffers are then parsed before hidden ones are visited."""
+    current_buffer_number = vimsupport.GetCurrentBufferNumber()
+    buffer_numbers = [ bufnr for bufnr in self._buffers_to_replay
+                       if bufnr != current_buffer_number and
+                          vimsupport.BufferIsLoaded( bufnr ) ]
+    self._buffers_to_replay = []
+
+    visible_buffers = [ bufnr for bufnr in buffer_numbers
+                        if vimsupport.BufferIsVisible( bufnr ) ]
+    hidden_buffers = [ bufnr for bufnr in buffer_numbers
+                       if bufnr not in visible_buffers ]
+
+    extra_data = {}
+    self._AddExtraConfDataIfNeeded( extra_data )
+    for bufnr in visible_buffers:
+      SendEventNotificationAsync( 'BufferVisit', bufnr )
+      SendEventNotificationAsync( 'FileReadyToParse', bufnr, extra_data )
+    for bufnr in hidden_buffers:
+      SendEventNotificationAsync( 'BufferVisit', bufnr )
+
+
   def ServerPid( self ):
     if not self._server_popen:
       return -1
     return self._server_popen.pid
 
 
-  def _ShutdownServer( self ):
+  def _ShutdownServer( self, force = False ):
+    if self._UseSharedServer():
+      # Leave the shared server running while other Vim instances use it,
+      # unless the user explicitly asked for a restart.
+      if shared_server.UnregisterClient() and not force:
+        return
+      shared_server.ClearServerState()
     SendShutdownRequest()
 
 
   def RestartServer( self ):
-    vimsupport.PostVimMessage( 'Restarting ycmd server...' )
-    self._ShutdownServer()
-    self._SetUpServer()
+    if self._UseSharedServer() and shared_server.UnregisterClient():
+      # Shutting down the shared server would break the other Vim instances
+      # using it. Leave it to them and start a private server instead.
+      vimsupport.PostVimMessage(
+        'The shared ycmd server is used by other Vim instances; starting a '
+        'private ycmd server for this one...' )
+      self._detached_from_shared_server = True
+    else:
+      vimsupport.PostVimMessage( 'Restarting ycmd server...' )
+      self._ShutdownServer( force = True )
+    self._server_recovery_attempts = 0
+    self._server_recovery_time = None
+    self._ResetServer()
+
+
+  def ReloadOptions( self ):
+    """Takes a new snapshot of the options. Options passed to the server when
+    it was started only take effect after restarting it."""
+    self._user_options = base.GetUserOptions( self._default_options )
+    self._SetLogLevel()
+    # Recreated with the new options the next time it is needed.
+    self._omnicomp = None
+    self._buffers.UpdateOptions( self._user_options )
+    self._buffer_prefetcher = self._CreateBufferPrefetcher()
 
 
   def SendCompletionRequest( self, force_semantic = False ):
     request_data = BuildRequestData()
     request_data[ 'force_semantic' ] = force_semantic
 
+    self._CountSupersededRequest( self._latest_completion_request,
+                                  'completions' )
     if not self.NativeFiletypeCompletionUsable():
+      from ycmd.request_wrap import RequestWrap
+      from ycm.client.omni_completion_request import OmniCompletionRequest
+
       wrapped_request_data = RequestWrap( request_data )
-      if self._omnicomp.ShouldUseNow( wrapped_request_data ):
+      omnicomp = self.GetOmniCompleter()
+      if omnicomp.ShouldUseNow( wrapped_request_data ):
         self._latest_completion_request = OmniCompletionRequest(
-            self._omnicomp, wrapped_request_data )
+            omnicomp, wrapped_request_data )
         self._latest_completion_request.Start()
         return
 
@@ -296,6 +584,11 @@ class YouCompleteMe:
     self._latest_completion_request.Start()
 
 
+  def _CountSupersededRequest( self, request, handler ):
+    if request is not None and not request.Done():
+      metrics.Increment( 'superseded_requests', handler )
+
+
   def CompletionRequestReady( self ):
     return bool( self._latest_completion_request and
                  self._latest_completion_request.Done() )
@@ -339,12 +632,24 @@ class YouCompleteMe:
         return False
 
       request_data = self._latest_completion_request.request_data.copy()
+
+      # The signature help displayed is still valid while the same argument of
+      # the same call is being typed.
+      signature_help_key = self._SignatureHelpKey( request_data )
+      if signature_help_key is not None:
+        reused = signature_help_key == self._signature_help_key
+        metrics.RecordCacheLookup( 'signature_help', reused )
+        if reused:
+          return False
+
       request_data[ 'signature_help_state' ] = (
           self._signature_help_state.IsActive()
       )
 
       self._AddExtraConfDataIfNeeded( request_data )
 
+      self._CountSupersededRequest( self._latest_signature_help_request,
+                                    'signature_help' )
       self._latest_signature_help_request = SignatureHelpRequest( request_data )
       self._latest_signature_help_request.Start()
       return True
@@ -371,6 +676,37 @@ class YouCompleteMe:
     self._signature_help_state = signature_help.UpdateSignatureHelp(
       self._signature_help_state,
       signature_info )
+    self._signature_help_key = None
+    if ( signature_info.get( 'signatures' ) and
+         self._latest_signature_help_request ):
+      self._signature_help_key = self._SignatureHelpKey(
+        self._latest_signature_help_request.request_data )
+
+
+  def _SignatureHelpKey( self, request_data ):
+    """Returns a key identifying the call and the argument at the position of
+    |request_data| or None if they can't be identified."""
+    anchor = self._signature_help_state.anchor
+    if anchor is None:
+      return None
+    anchor_line, anchor_column = anchor
+    # Line and column numbers are 1-based in requests.
+    line = request_data[ 'line_num' ] - 1
+    column = request_data[ 'column_num' ] - 1
+    if ( line != anchor_line or
+         column < anchor_column or
+         line != vimsupport.CurrentLineAndColumn()[ 0 ] ):
+      return None
+
+    contents = vimsupport.CurrentLineBytes()
+    argument_index = signature_help.ArgumentIndex(
+      contents[ anchor_column : column ] )
+    if argument_index is None:
+      return None
+    return ( request_data[ 'filepath' ],
+             anchor,
+             contents[ : anchor_column ],
+             argument_index )
 
 
   def _GetCommandRequestArguments( self,
@@ -418,7 +754,7 @@ class YouCompleteMe:
     return SendCommandRequest(
       final_arguments,
       modifiers,
-      self._user_options[ 'goto_buffer_command' ],
+      self._user_options.goto_buffer_command,
       extra_data )
 
 
@@ -466,41 +802,130 @@ class YouCompleteMe:
 
 
   def GetOmniCompleter( self ):
+    # Importing the omnicompleter loads the ycmd completer framework, which is
+    # slow. Only do it when needed.
+    if not self._omnicomp:
+      from ycm.omni_completer import OmniCompleter
+      self._omnicomp = OmniCompleter( self._user_options )
     return self._omnicomp
 
 
-  def FiletypeCompleterExistsForFiletype( self, filetype ):
-    try:
-      return self._available_completers[ filetype ]
-    except KeyError:
-      pass
+  def FiletypeCompleterExistsForFiletype( self, filetype, block = False ):
+    """Unless |block| is True, never wait for the server: the filetype is
+    assumed to have no semantic completer until it answers. Explicit commands
+    must block since they would otherwise fail with a cold cache."""
+    self._HandleCompleterAvailableResponses()
+    self._CheckCompleterAvailability( filetype )
+    if block and filetype not in self._available_completers:
+      self._WaitForCompleterAvailability( filetype )
+    return self._available_completers.get( filetype, False )
+
+
+  def _CheckCompleterAvailability( self, filetype ):
+    """Asks the server if it has a semantic completer for |filetype|. Until it
+    answers, the answer from a previous session is used if any."""
+    if ( filetype in self._available_completers or
+         filetype in self._completer_available_requests ):
+      return
+
+    cached_answer = self._completer_availability_cache.Get( filetype )
+    if cached_answer is not None:
+      self._SetCompleterAvailable( filetype, cached_answer )
+    self._completer_available_requests[ filetype ] = (
+      SendCompleterAvailableRequestAsync( filetype ) )
+
+
+  def _WaitForCompleterAvailability( self, filetype ):
+    request = self._completer_available_requests.get( filetype )
+    if request:
+      # Waits for the server to answer.
+      request.Response()
+    self._HandleCompleterAvailableResponses()
+
+
+  def _HandleCompleterAvailableResponses( self ):
+    for filetype, request in list( self._completer_available_requests.items() ):
+      if not request.Done():
+        continue
+      del self._completer_available_requests[ filetype ]
+      exists_completer = request.Response()
+      # The server will be asked again next time.
+      if exists_completer is None:
+        continue
+      self._SetCompleterAvailable( filetype, bool( exists_completer ) )
+      self._completer_availability_cache.Set( filetype,
+                                              bool( exists_completer ) )
+
+
+  def _SetCompleterAvailable( self, filetype, available ):
+    self._available_completers[ filetype ] = available
+    vimsupport.SetSemanticCompleterAvailable( filetype, available )
 
-    exists_completer = SendCompleterAvailableRequest( filetype )
-    if exists_completer is None:
-      return False
 
-    self._available_completers[ filetype ] = exists_completer
-    return exists_completer
+  def CompleterAvailabilityPending( self ):
+    self._HandleCompleterAvailableResponses()
+    return any( filetype in self._completer_available_requests and
+                filetype not in self._available_completers
+                for filetype in vimsupport.CurrentFiletypes() )
 
 
-  def NativeFiletypeCompletionAvailable( self ):
-    return any( self.FiletypeCompleterExistsForFiletype( x ) for x in
+  def NativeFiletypeCompletionAvailable( self, block = False ):
+    return any( self.FiletypeCompleterExistsForFiletype( x, block ) for x in
                 vimsupport.CurrentFiletypes() )
 
 
-  def NativeFiletypeCompletionUsable( self ):
-    disabled_filetypes = self._user_options[
-      'filetype_specific_completion_to_disable' ]
+  def NativeFiletypeCompletionUsable( self, block = False ):
+    disabled_filetypes = (
+      self._user_options.filetype_specific_completion_to_disable )
     return ( vimsupport.CurrentFiletypesEnabled( disabled_filetypes ) and
-             self.NativeFiletypeCompletionAvailable() )
+             self.NativeFiletypeCompletionAvailable( block ) )
+
+
+  def _CreateBufferPrefetcher( self ):
+    return BufferPrefetcher( self._user_options.prefetch_buffers,
+                             self._HasSemanticCompleter,
+                             self.Buffer )
+
+
+  def _HasSemanticCompleter( self, filetypes ):
+    # Only rely on the filetypes already checked so that we never block Vim.
+    disabled_filetypes = (
+      self._user_options.filetype_specific_completion_to_disable )
+    return ( '*' not in disabled_filetypes and
+             not any( x in disabled_filetypes for x in filetypes ) and
+             any( self._available_completers.get( x ) for x in filetypes ) )
+
+
+  def StartBufferPrefetch( self ):
+    if not self.IsServerReady():
+      return
+    extra_data = {}
+    self._AddExtraConfDataIfNeeded( extra_data )
+    self._buffer_prefetcher.Start( list( self._buffers ), extra_data )
+
+
+  def PollBufferPrefetch( self ):
+    return self._buffer_prefetcher.Poll()
+
+
+  def StopBufferPrefetch( self ):
+    self._buffer_prefetcher.Stop()
+
+
+  def UsePrefetchedParse( self ):
+    return self.CurrentBuffer().UsePrefetchedParse()
 
 
   def NeedsReparse( self ):
     return self.CurrentBuffer().NeedsReparse()
 
 
+  def ParseDelay( self ):
+    return self.CurrentBuffer().ParseDelay()
+
+
   def UpdateWithNewDiagnosticsForFile( self, filepath, diagnostics ):
-    if not self._user_options[ 'show_diagnostics_ui' ]:
+    if not self._user_options.show_diagnostics_ui:
       return
 
     bufnr = vimsupport.GetBufferNumberForFilename( filepath )
@@ -541,15 +966,25 @@ class YouCompleteMe:
       # Try again in a jiffy
       return True
 
+    # Each poll keeps a request open on the server for up to a minute, taking
+    # up a thread, so filetypes are only polled once and while they are
+    # displayed.
+    buffers_for_filetype = {}
     for w in vim.windows:
       for filetype in vimsupport.FiletypesForBuffer( w.buffer ):
-        if filetype not in self._message_poll_requests:
-          self._message_poll_requests[ filetype ] = MessagesPoll( w.buffer )
+        buffers_for_filetype.setdefault( filetype, w.buffer )
+
+    for filetype, buff in buffers_for_filetype.items():
+      if filetype not in self._message_poll_requests:
+        # Only semantic completers send messages.
+        if self._available_completers.get( filetype ) is False:
+          continue
+        self._message_poll_requests[ filetype ] = MessagesPoll( buff )
 
-        # None means don't poll this filetype
-        if ( self._message_poll_requests[ filetype ] and
-             not self._message_poll_requests[ filetype ].Poll( self ) ):
-          self._message_poll_requests[ filetype ] = None
+      # None means don't poll this filetype
+      if ( self._message_poll_requests[ filetype ] and
+           not self._message_poll_requests[ filetype ].Poll( self, buff ) ):
+        self._message_poll_requests[ filetype ] = None
 
     return any( self._message_poll_requests.values() )
 
@@ -563,11 +998,29 @@ class YouCompleteMe:
       return
 
     extra_data = {}
-    self._AddTagsFilesIfNeeded( extra_data )
-    self._AddSyntaxDataIfNeeded( extra_data )
+    sent_data = {}
+    self._AddTagsFilesIfNeeded( extra_data, sent_data )
+    self._AddSyntaxDataIfNeeded( extra_data, sent_data )
     self._AddExtraConfDataIfNeeded( extra_data )
 
-    self.CurrentBuffer().SendParseRequest( extra_data )
+    # The tag files and syntax keywords are only known to the server once it
+    # answered the request. If the request isn't sent because another one is in
+    # progress, or if it fails, they are sent again with the next one.
+    server_location = BaseRequest.server_location
+    self.CurrentBuffer().SendParseRequest(
+      extra_data,
+      on_success = lambda: self._RecordSentData( server_location, sent_data ) )
+
+
+  def _RecordSentData( self, server_location, sent_data ):
+    # Called from the thread that sent the parse request.
+    if server_location != BaseRequest.server_location:
+      # The server was restarted or replaced in the meantime.
+      return
+    if 'syntax_keywords' in sent_data:
+      filetype, keywords = sent_data[ 'syntax_keywords' ]
+      self._syntax_keywords_sent[ filetype ] = keywords
+    self._tag_files_sent.update( sent_data.get( 'tag_files', {} ) )
 
 
   def OnFileSave( self, saved_buffer_number ):
@@ -576,6 +1029,13 @@ class YouCompleteMe:
 
   def OnBufferUnload( self, deleted_buffer_number ):
     SendEventNotificationAsync( 'BufferUnload', deleted_buffer_number )
+    vimsupport.ForgetBufferData( deleted_buffer_number )
+
+
+  def OnBufferWipeout( self, buffer_number ):
+    self._buffers.pop( buffer_number, None )
+    vimsupport.ForgetBufferData( buffer_number )
+    vimsupport.ForgetLargeFile( buffer_number )
 
 
   def UpdateMatches( self ):
@@ -586,6 +1046,9 @@ class YouCompleteMe:
     buffer_number = vimsupport.GetCurrentBufferNumber()
     filetypes = vimsupport.CurrentFiletypes()
     self._buffers[ buffer_number ].UpdateFromFileTypes( filetypes )
+    if self.IsServerReady():
+      for filetype in filetypes:
+        self._CheckCompleterAvailability( filetype )
     self.OnBufferVisit()
 
 
@@ -609,14 +1072,14 @@ class YouCompleteMe:
 
 
   def OnInsertEnter( self ):
-    if not self._user_options[ 'update_diagnostics_in_insert_mode' ]:
+    if not self._user_options.update_diagnostics_in_insert_mode:
       self.CurrentBuffer().ClearDiagnosticsUI()
 
 
   def OnInsertLeave( self ):
     async_diags = any( self._message_poll_requests.get( filetype )
                       for filetype in vimsupport.CurrentFiletypes() )
-    if ( not self._user_options[ 'update_diagnostics_in_insert_mode' ] and
+    if ( not self._user_options.update_diagnostics_in_insert_mode and
          ( async_diags or not self.CurrentBuffer().ParseRequestPending() ) ):
       self.CurrentBuffer().RefreshDiagnosticsUI()
     SendEventNotificationAsync( 'InsertLeave' )
@@ -626,15 +1089,28 @@ class YouCompleteMe:
     self.CurrentBuffer().OnCursorMoved()
 
 
+  def OnWinScrolled( self, bufnr ):
+    # Only the diagnostics around the displayed lines of large files are shown.
+    if not vimsupport.IsLargeFile( bufnr ):
+      return
+    diag_interface = self.Buffer( bufnr ).diag_interface
+    if diag_interface.ShouldUpdateDiagnosticsUINow():
+      diag_interface.UpdateSignsAndMatches()
+
+
   def _CleanLogfile( self ):
     logging.shutdown()
-    if not self._user_options[ 'keep_logfiles' ]:
+    if not self._user_options.keep_logfiles:
       if self._client_logfile:
         utils.RemoveIfExists( self._client_logfile )
 
 
   def OnVimLeave( self ):
+    self._DumpStats()
     self._ShutdownServer()
+    self._ycmd_keepalive.SetStandbyServer( None, None )
+    self._StopStandbyServer( self._standby_server )
+    self._standby_server = None
     self._CleanLogfile()
 
 
@@ -682,13 +1158,15 @@ class YouCompleteMe:
 
   def _PopulateLocationListWithLatestDiagnostics( self ):
     return self.CurrentBuffer().PopulateLocationList(
-        self._user_options[ 'open_loclist_on_ycm_diags' ] )
+        self._user_options.open_loclist_on_ycm_diags )
 
 
   def FileParseRequestReady( self ):
     # Return True if server is not ready yet, to stop repeating check timer.
+    # Otherwise, also wait until we know if the diagnostics should be shown.
     return ( not self.IsServerReady() or
-             self.CurrentBuffer().FileParseRequestReady() )
+             ( self.CurrentBuffer().FileParseRequestReady() and
+               not self.CompleterAvailabilityPending() ) )
 
 
   def HandleFileParseRequest( self, block = False ):
@@ -698,12 +1176,12 @@ class YouCompleteMe:
     current_buffer = self.CurrentBuffer()
     # Order is important here:
     # FileParseRequestReady has a low cost, while
-    # NativeFiletypeCompletionUsable is a blocking server request
+    # NativeFiletypeCompletionUsable may send a server request
     if ( not current_buffer.IsResponseHandled() and
          current_buffer.FileParseRequestReady( block ) and
-         self.NativeFiletypeCompletionUsable() ):
+         self.NativeFiletypeCompletionUsable( block ) ):
 
-      if self._user_options[ 'show_diagnostics_ui' ]:
+      if self._user_options.show_diagnostics_ui:
         # Forcefuly update the location list, etc. from the parse request when
         # doing something like :YcmDiags
         async_diags = any( self._message_poll_requests.get( filetype )
@@ -731,7 +1209,75 @@ class YouCompleteMe:
     return self.CurrentBuffer().ShouldResendParseRequest()
 
 
+  def _BuffersDebugInfo( self ):
+    buffer_sizes = sorted( ( ( buffer.MemoryUsage(), bufnr )
+                             for bufnr, buffer in self._buffers.items() ),
+                           reverse = True )
+    debug_info = ( f'Client buffers: { len( buffer_sizes ) } '
+                   f'({ sum( size for size, _ in buffer_sizes ) / 1024:.1f} '
+                   'KiB)\n' )
+    for size, bufnr in buffer_sizes[ : MAX_BUFFERS_IN_DEBUG_INFO ]:
+      debug_info += f'  Buffer { bufnr }: { size / 1024:.1f} KiB\n'
+    return debug_info
+
+
+  def Stats( self ):
+    stats = metrics.Snapshot()
+    latencies = {}
+    for handler, histogram in LatencyHistogramsSnapshot():
+      latencies[ handler ] = {
+        'count': histogram.count,
+        'timeouts': histogram.timeouts,
+        'p50_ms': round( histogram.Quantile( 0.5 ) * 1000, 1 ),
+        'p99_ms': round( histogram.Quantile( 0.99 ) * 1000, 1 ),
+        'p99.9_ms': round( histogram.Quantile( 0.999 ) * 1000, 1 ),
+        'timeout_s': AdaptiveTimeout( handler )
+      }
+    if latencies:
+      stats[ 'request_latencies' ] = latencies
+    return stats
+
+
+  def FormatStats( self ):
+    return metrics.FormatReport( self.Stats() )
+
+
+  def _DumpStats( self ):
+    """Appends the statistics of this session as a line of JSON to the file
+    set by the stats_file option."""
+    stats_file = self._user_options.stats_file
+    if not stats_file:
+      return
+    stats = {
+      'time': int( time.time() ),
+      'session_seconds': round( time.monotonic() - self._session_start_time ),
+      'stats': self.Stats()
+    }
+    try:
+      with open( os.path.expanduser( stats_file ), 'a' ) as stats_file_handle:
+        stats_file_handle.write( json.dumps( stats ) + '\n' )
+    except OSError:
+      self._logger.exception( 'Failed to write statistics to %s', stats_file )
+
+
+  def _RequestLatenciesDebugInfo( self ):
+    histograms = LatencyHistogramsSnapshot()
+    if not histograms:
+      return ''
+    debug_info = 'Request latencies:\n'
+    for handler, histogram in histograms:
+      debug_info += (
+        f'  { handler }: p50 { histogram.Quantile( 0.5 ) * 1000:.1f} ms, '
+        f'p99.9 { histogram.Quantile( 0.999 ) * 1000:.1f} ms, '
+        f'timeout { AdaptiveTimeout( handler ):.1f} s '
+        f'({ histogram.count } requests, { histogram.timeouts } timeouts)\n' )
+    return debug_info
+
+
   def DebugInfo( self ):
+    from ycm.client.debug_info_request import ( SendDebugInfoRequest,
+                                                FormatDebugInfoResponse )
+
     debug_info = ''
     if self._client_logfile:
       debug_info += f'Client logfile: { self._client_logfile }\n'
@@ -741,6 +1287,14 @@ class YouCompleteMe:
     debug_info += f'Server running at: { BaseRequest.server_location }\n'
     if self._server_popen:
       debug_info += f'Server process ID: { self._server_popen.pid }\n'
+    debug_info += f'Server crashes: { self._server_crash_count }\n'
+    round_trip_statistics = GetRoundTripStatistics()
+    if round_trip_statistics.count:
+      debug_info += ( 'Server round-trip time: '
+                      f'{ round_trip_statistics.smoothed_seconds * 1000:.1f} '
+                      f'ms ({ round_trip_statistics.count } requests)\n' )
+    debug_info += self._RequestLatenciesDebugInfo()
+    debug_info += self._BuffersDebugInfo()
     if self._server_stdout and self._server_stderr:
       debug_info += ( 'Server logfiles:\n'
                       f'  { self._server_stdout }\n'
@@ -755,6 +1309,8 @@ class YouCompleteMe:
 
 
   def GetLogfiles( self ):
+    from ycm.client.debug_info_request import SendDebugInfoRequest
+
     logfiles_list = [ self._client_logfile,
                       self._server_stdout,
                       self._server_stderr ]
@@ -876,7 +1432,7 @@ class YouCompleteMe:
 
 
   def ForceCompileAndDiagnostics( self ):
-    if not self.NativeFiletypeCompletionUsable():
+    if not self.NativeFiletypeCompletionUsable( block = True ):
       vimsupport.PostVimMessage(
           'Native filetype completion not supported for current file, '
           'cannot force recompilation.', warning = False )
@@ -899,7 +1455,7 @@ class YouCompleteMe:
                                  warning = False )
       return
 
-    if self._user_options[ 'open_loclist_on_ycm_diags' ]:
+    if self._user_options.open_loclist_on_ycm_diags:
       vimsupport.OpenLocationList( focus = True )
 
 
@@ -920,29 +1476,61 @@ class YouCompleteMe:
     self._signature_help_state.ToggleVisibility()
 
 
-  def _AddSyntaxDataIfNeeded( self, extra_data ):
-    if not self._user_options[ 'seed_identifiers_with_syntax' ]:
+  def _AddSyntaxDataIfNeeded( self, extra_data, sent_data ):
+    if not self._user_options.seed_identifiers_with_syntax:
+      return
+    # Extracting the keywords runs :syntax list, which is slow in large files.
+    if vimsupport.IsLargeFile( vimsupport.GetCurrentBufferNumber() ):
       return
     filetype = vimsupport.CurrentFiletypes()[ 0 ]
     if filetype in self._filetypes_with_keywords_loaded:
       return
 
-    if self.IsServerReady():
+    from ycm import syntax_keywords_cache
+
+    keywords = syntax_keywords_cache.SyntaxKeywordsForCurrentBuffer( filetype )
+    # ycmd replaces the syntax keywords of a filetype with the ones it receives
+    # so the whole set must be sent, but only if it changed.
+    if self._syntax_keywords_sent.get( filetype ) == keywords:
       self._filetypes_with_keywords_loaded.add( filetype )
-    extra_data[ 'syntax_keywords' ] = list(
-       syntax_parse.SyntaxKeywordsForCurrentBuffer() )
+      return
+    extra_data[ 'syntax_keywords' ] = list( keywords )
+    sent_data[ 'syntax_keywords' ] = ( filetype, keywords )
+
 
+  def OnSyntaxSet( self, syntax ):
+    # The syntax files were (re)loaded; check if the keywords changed on the
+    # next parse.
+    filetype = syntax.split( '.' )[ 0 ]
+    self._filetypes_with_keywords_loaded.discard( filetype )
 
-  def _AddTagsFilesIfNeeded( self, extra_data ):
+
+  def _AddTagsFilesIfNeeded( self, extra_data, sent_data ):
     def GetTagFiles():
       tag_files = vim.eval( 'tagfiles()' )
       return [ ( os.path.join( utils.GetCurrentDirectory(), tag_file )
                  if not os.path.isabs( tag_file ) else tag_file )
                for tag_file in tag_files ]
 
-    if not self._user_options[ 'collect_identifiers_from_tags_files' ]:
+    if not self._user_options.collect_identifiers_from_tags_files:
       return
-    extra_data[ 'tag_files' ] = GetTagFiles()
+
+    # ycmd keeps the identifiers of the tag files it already read so only send
+    # the ones that are new or changed since then.
+    tag_files = {}
+    for tag_file in GetTagFiles():
+      try:
+        stat = os.stat( tag_file )
+      except OSError:
+        continue
+      signature = ( stat.st_mtime_ns, stat.st_size )
+      if self._tag_files_sent.get( tag_file ) == signature:
+        continue
+      tag_files[ tag_file ] = signature
+
+    if tag_files:
+      extra_data[ 'tag_files' ] = list( tag_files )
+      sent_data[ 'tag_files' ] = tag_files
 
 
   def _AddExtraConfDataIfNeeded( self, extra_data ):
@@ -959,7 +1547,7 @@ class YouCompleteMe:
           self._logger.exception( message )
       return extra_conf_data
 
-    extra_conf_vim_data = self._user_options[ 'extra_conf_vim_data' ]
+    extra_conf_vim_data = self._user_options.extra_conf_vim_data
     if extra_conf_vim_data:
       extra_data[ 'extra_conf_data' ] = BuildExtraConfData(
         extra_conf_vim_data )
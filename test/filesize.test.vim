@@ -44,3 +44,23 @@ function! Test_Open_Supported_Filetype_Messages()
 
   call delete( 'Xtest' )
 endfunction
+
+function! Test_Open_Supported_Filetype_Large_File_Mode_Messages()
+  let g:ycm_large_file_mode = 1
+  enew
+
+  let X = join( map( range( 0, 1000 * 1024 + 1 ), {->'X'} ), '' )
+  call append( line( '$' ), X )
+
+  silent w! Xtest
+  setf cpp
+
+  let l:stderr = substitute( execute( '1messages' ), '\n', '\t', 'g' )
+  call assert_match( 'YouCompleteMe is in large file mode in this buffer',
+        \ stderr )
+  call assert_equal( 0, b:ycm_largefile )
+  messages clear
+
+  call delete( 'Xtest' )
+  let g:ycm_large_file_mode = 0
+endfunction